@@ -0,0 +1,44 @@
+#ifndef FFTBATCH_H
+#define FFTBATCH_H
+
+#include "Complex.h"
+
+// Helpers of the batched FFTransformBatch entry points. A batch is howmany
+// transforms of one plan, element j of transform i at data[i * dist + j * stride].
+// dist == 0 packs the transforms back to back (dist = length * stride).
+
+//transforms up to this many bytes are prefetched as a whole while the one before runs,
+//the bit reversed access pattern of the first pass defeats the hardware prefetcher
+const int FFT_BATCH_PREFETCH_BYTES = 16384;
+
+template <class FLOAT>
+inline void FFTBatchPrefetch(const Complex<FLOAT> *data, int length)
+{
+    const int bytes = length * sizeof(Complex<FLOAT>);
+    if (bytes > FFT_BATCH_PREFETCH_BYTES) return;
+    for (int offset = 0; offset < bytes; offset += 64)
+    {
+        __builtin_prefetch((const char*)data + offset, 1, 3);
+    }
+}
+
+//non-unit strides run through a contiguous per-thread copy
+template <class FLOAT>
+inline void FFTBatchGather(const Complex<FLOAT> *src, int stride, Complex<FLOAT> *dst, int length)
+{
+    for (int j = 0; j < length; j++)
+    {
+        dst[j] = src[j * stride];
+    }
+}
+
+template <class FLOAT>
+inline void FFTBatchScatter(const Complex<FLOAT> *src, Complex<FLOAT> *dst, int stride, int length)
+{
+    for (int j = 0; j < length; j++)
+    {
+        dst[j * stride] = src[j];
+    }
+}
+
+#endif // FFTBATCH_H
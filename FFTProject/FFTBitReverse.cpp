@@ -0,0 +1,148 @@
+#include "FFTBitReverse.h"
+
+template <class FLOAT>
+FFTBitReverse<FLOAT>::FFTBitReverse() : length(0), bits(0), rev_block(0), rev_middle(0)
+{
+    //do nothing
+}
+
+template <class FLOAT>
+FFTBitReverse<FLOAT>::~FFTBitReverse()
+{
+    if (this->rev_block != 0)
+    {
+        delete[] rev_block;
+    }
+    if (this->rev_middle != 0)
+    {
+        delete[] rev_middle;
+    }
+}
+
+template <class FLOAT>
+uint FFTBitReverse<FLOAT>::reverseBits(uint v, int bits)
+{
+    uint r = 0;
+    for (int i = 0; i < bits; i++)
+    {
+        r = (r << 1) | (v & 1);
+        v >>= 1;
+    }
+    return r;
+}
+
+template <class FLOAT>
+bool FFTBitReverse<FLOAT>::Init(int length)
+{
+    if (length < 4 * BLOCK * BLOCK || ((length - 1) & length) != 0)
+        return false;
+    if (this->rev_block != 0)
+    {
+        delete[] rev_block;
+    }
+    if (this->rev_middle != 0)
+    {
+        delete[] rev_middle;
+    }
+    this->length = length;
+    this->bits = 31 - __builtin_clz(length);
+    int middle_bits = bits - 2 * BLOCK_BITS;
+    this->rev_block  = new uint[BLOCK];
+    this->rev_middle = new uint[1 << middle_bits];
+    for (int i = 0; i < BLOCK; i++)
+    {
+        rev_block[i] = reverseBits(i, BLOCK_BITS);
+    }
+    for (int i = 0; i < (1 << middle_bits); i++)
+    {
+        rev_middle[i] = reverseBits(i, middle_bits);
+    }
+    return true;
+}
+
+template <class FLOAT>
+void FFTBitReverse<FLOAT>::Shuffle(Complex<FLOAT>* data)
+{
+    //two tiles on the stack, the shuffle may run on several threads at once
+    Complex<FLOAT> tile_c[BLOCK * BLOCK];
+    Complex<FLOAT> tile_r[BLOCK * BLOCK];
+    const int middle_count = 1 << (bits - 2 * BLOCK_BITS);
+    const int high_shift = bits - BLOCK_BITS;
+    for (int c = 0; c < middle_count; c++)
+    {
+        int rc = rev_middle[c];
+        if (rc < c) continue;
+        //tile[rev(a)][b] = data[a | c | b]
+        for (int a = 0; a < BLOCK; a++)
+        {
+            const Complex<FLOAT> *src_c = &data[(a << high_shift) | (c << BLOCK_BITS)];
+            const Complex<FLOAT> *src_r = &data[(a << high_shift) | (rc << BLOCK_BITS)];
+            Complex<FLOAT> *dst_c = &tile_c[rev_block[a] * BLOCK];
+            Complex<FLOAT> *dst_r = &tile_r[rev_block[a] * BLOCK];
+            for (int b = 0; b < BLOCK; b++)
+            {
+                dst_c[b] = src_c[b];
+            }
+            if (rc != c)
+            {
+                for (int b = 0; b < BLOCK; b++)
+                {
+                    dst_r[b] = src_r[b];
+                }
+            }
+        }
+        //data[a | rev(c) | b] = tile[b][rev(a)]
+        for (int a = 0; a < BLOCK; a++)
+        {
+            Complex<FLOAT> *dst_c = &data[(a << high_shift) | (c << BLOCK_BITS)];
+            Complex<FLOAT> *dst_r = &data[(a << high_shift) | (rc << BLOCK_BITS)];
+            const int ra = rev_block[a];
+            for (int b = 0; b < BLOCK; b++)
+            {
+                dst_r[b] = tile_c[b * BLOCK + ra];
+            }
+            if (rc != c)
+            {
+                for (int b = 0; b < BLOCK; b++)
+                {
+                    dst_c[b] = tile_r[b * BLOCK + ra];
+                }
+            }
+        }
+    }
+}
+
+template <class FLOAT>
+void FFTBitReverse<FLOAT>::Shuffle(const Complex<FLOAT>* in, Complex<FLOAT>* out)
+{
+    //every middle index is read and written once, no pairing of c and rev(c)
+    Complex<FLOAT> tile[BLOCK * BLOCK];
+    const int middle_count = 1 << (bits - 2 * BLOCK_BITS);
+    const int high_shift = bits - BLOCK_BITS;
+    for (int c = 0; c < middle_count; c++)
+    {
+        const int rc = rev_middle[c];
+        for (int a = 0; a < BLOCK; a++)
+        {
+            const Complex<FLOAT> *src = &in[(a << high_shift) | (c << BLOCK_BITS)];
+            Complex<FLOAT> *dst = &tile[rev_block[a] * BLOCK];
+            for (int b = 0; b < BLOCK; b++)
+            {
+                dst[b] = src[b];
+            }
+        }
+        for (int a = 0; a < BLOCK; a++)
+        {
+            Complex<FLOAT> *dst = &out[(a << high_shift) | (rc << BLOCK_BITS)];
+            const int ra = rev_block[a];
+            for (int b = 0; b < BLOCK; b++)
+            {
+                dst[b] = tile[b * BLOCK + ra];
+            }
+        }
+    }
+}
+
+template class FFTBitReverse<float>;
+template class FFTBitReverse<double>;
+template class FFTBitReverse<long double>;
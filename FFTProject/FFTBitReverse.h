@@ -0,0 +1,40 @@
+#ifndef FFTBITREVERSE_H
+#define FFTBITREVERSE_H
+
+#include "Complex.h"
+
+typedef unsigned int uint;
+
+// Blocked in-place bit reversal permutation (Carter and Gatlin, "Towards an
+// optimal bit-reversal permutation program"). The index is split into
+// a | c | b with BLOCK_BITS wide a and b. The B x B tile of a middle index c
+// and the tile of its reverse are read row by row into a small buffer and
+// written back transposed, so memory is only touched in whole cache lines.
+// Used by the transformers for lengths of MIN_LENGTH and above.
+template <class FLOAT>
+class FFTBitReverse
+{
+    private:
+        static const int BLOCK_BITS = 4;
+        static const int BLOCK = 1 << BLOCK_BITS;
+
+        int length;
+        int bits;
+        uint *rev_block;
+        uint *rev_middle;
+
+    public:
+        static const int MIN_LENGTH = 65536;
+
+        FFTBitReverse();
+        virtual ~FFTBitReverse();
+
+        static uint reverseBits(uint v, int bits);
+
+        bool Init(int length);
+        void Shuffle(Complex<FLOAT> *data);
+        //out of place: out[rev(i)] = in[i], in and out must not overlap
+        void Shuffle(const Complex<FLOAT> *in, Complex<FLOAT> *out);
+};
+
+#endif // FFTBITREVERSE_H
@@ -0,0 +1,53 @@
+#include <cstdio>
+#include "instrset.h"
+#include "FFTDispatch.h"
+
+static int kernelLevel = -1;
+
+static int FFTDetectInstrset()
+{
+    int iset = instrset_detect();
+    if (iset >= 8 && hasFMA3()) iset = FFT_INSTRSET_FMA3;
+    return iset;
+}
+
+static int FFTKernelLevel()
+{
+    if (kernelLevel < 0)
+    {
+        kernelLevel = FFTDetectInstrset();
+        if (kernelLevel < 2)
+        {
+            fprintf(stderr, "\nError: Instruction set SSE2 not supported on this computer");
+            kernelLevel = 2;
+        }
+    }
+    return kernelLevel;
+}
+
+template <>
+const FFTKernelTable<float> &FFTKernels<float>()
+{
+    int iset = FFTKernelLevel();
+    if      (iset >= FFT_INSTRSET_FMA3) return FFTKernels_FMA3;
+    else if (iset >= 8) return FFTKernels_AVX2;
+    else if (iset >= 7) return FFTKernels_AVX;
+    return FFTKernels_SSE2;
+}
+
+template <>
+const FFTKernelTable<double> &FFTKernels<double>()
+{
+    int iset = FFTKernelLevel();
+    if      (iset >= FFT_INSTRSET_FMA3) return FFTKernelsDouble_FMA3;
+    else if (iset >= 8) return FFTKernelsDouble_AVX2;
+    else if (iset >= 7) return FFTKernelsDouble_AVX;
+    return FFTKernelsDouble_SSE2;
+}
+
+bool FFTSelectKernels(int instrset)
+{
+    if (instrset < 2 || instrset > FFTDetectInstrset()) return false;
+    kernelLevel = instrset;
+    return true;
+}
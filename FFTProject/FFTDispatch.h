@@ -0,0 +1,77 @@
+#ifndef FFTDISPATCH_H
+#define FFTDISPATCH_H
+
+#include "Complex.h"
+
+typedef unsigned int uint;
+
+// Runtime CPU dispatch of the SIMD kernels from FFTVecKernels.h.
+// The kernels are compiled once per instruction set (FFTKernelsSSE2.cpp,
+// FFTKernelsAVX.cpp, FFTKernelsAVX2.cpp, FFTKernelsFMA3.cpp), each translation
+// unit with its own -m flags, and the fastest table supported by the CPU is bound on first use.
+// The function types must not contain vector types.
+
+//AVX2 with FMA3, one above the instrset_detect() levels
+const int FFT_INSTRSET_FMA3 = 9;
+
+//widest lanesBatch group over all instruction sets, 8 floats of AVX
+const int FFT_LANES_MAX = 8;
+
+//one table per precision, FLOAT is float or double
+template <class FLOAT>
+struct FFTKernelTable
+{
+    int instrset;
+    //direction 1 forward, 0 inverse. scale is the plan normalization, applied by
+    //the one pass of a transform that gets it and 1 everywhere else
+    void (*firstPass)(Complex<FLOAT> *data, int length, int direction, FLOAT scale);
+    //out of place first pass that also does the bit reversal, data[i] is read from src[perm[i] * stride].
+    //A stride other than 1 folds the gather of non-contiguous input into the pass
+    void (*firstPassGather)(const Complex<FLOAT> *src, Complex<FLOAT> *data, int length, const uint *perm, int stride, int direction, FLOAT scale);
+    void (*twiddlePass)(Complex<FLOAT> *data, int length, int twiddle_number, const Complex<FLOAT> *twiddles);
+    //twiddlePass restricted to the butterflies tw_begin <= k < tw_end of every group, both
+    //multiples of 8. Lets the top level combines of FFTransformerRecursive be split over threads
+    void (*twiddlePassRange)(Complex<FLOAT> *data, int length, int twiddle_number, const Complex<FLOAT> *twiddles, int tw_begin, int tw_end);
+    //radix-4 and radix-8 passes, fusing the stages twiddle_number .. 4 * twiddle_number
+    void (*twiddlePass4)(Complex<FLOAT> *data, int length, int twiddle_number, const Complex<FLOAT> *twiddles);
+    void (*twiddlePass8)(Complex<FLOAT> *data, int length, int twiddle_number, const Complex<FLOAT> *twiddles);
+    //out of place Stockham autosort steps, y may equal x for the last step
+    void (*stockhamPass4)(const Complex<FLOAT> *x, Complex<FLOAT> *y, int n, int s, const Complex<FLOAT> *twiddles, int direction, FLOAT scale);
+    void (*stockhamPass2)(const Complex<FLOAT> *x, Complex<FLOAT> *y, int n, int s, const Complex<FLOAT> *twiddles, FLOAT scale);
+    //radix 3, 5 or 7 Stockham step of the mixed radix engine
+    void (*stockhamPassOdd)(const Complex<FLOAT> *x, Complex<FLOAT> *y, int n, int s, int radix, const Complex<FLOAT> *twiddles, int direction, FLOAT scale);
+    //split of a half length transform into the spectrum of N real samples, see FFTransformerReal
+    void (*realPostPass)(Complex<FLOAT> *z, int half, const Complex<FLOAT> *twiddles, FLOAT scale);
+    //merge of the N/2 + 1 bins of a real signal into the half length inverse transform input
+    void (*realPrePass)(const Complex<FLOAT> *x, Complex<FLOAT> *z, int half, const Complex<FLOAT> *twiddles, FLOAT scale);
+    //Stockham steps on split real and imaginary arrays, see FFTransformerPlanar
+    void (*planarPass4)(const FLOAT *xr, const FLOAT *xi, FLOAT *yr, FLOAT *yi, int n, int s, const FLOAT *tw_re, const FLOAT *tw_im, int direction, FLOAT scale);
+    void (*planarPass2)(const FLOAT *xr, const FLOAT *xi, FLOAT *yr, FLOAT *yi, int n, int s, const FLOAT *tw_re, const FLOAT *tw_im, FLOAT scale);
+    //howmany transforms with one transform per SIMD lane, see FFTransformerLanes. work holds
+    //4 * FFT_LANES_MAX * (length + 4) FLOATs, 32 byte aligned
+    void (*lanesBatch)(const Complex<FLOAT> *in, Complex<FLOAT> *out, int length, int howmany, int stride, int dist,
+                       const Complex<FLOAT> *twiddles, FLOAT *work, int direction, FLOAT scale);
+};
+
+extern FFTKernelTable<float> FFTKernels_SSE2;
+extern FFTKernelTable<float> FFTKernels_AVX;
+extern FFTKernelTable<float> FFTKernels_AVX2;
+extern FFTKernelTable<float> FFTKernels_FMA3;
+
+extern FFTKernelTable<double> FFTKernelsDouble_SSE2;
+extern FFTKernelTable<double> FFTKernelsDouble_AVX;
+extern FFTKernelTable<double> FFTKernelsDouble_AVX2;
+extern FFTKernelTable<double> FFTKernelsDouble_FMA3;
+
+//kernel table for the running CPU, detected on the first call
+template <class FLOAT>
+const FFTKernelTable<FLOAT> &FFTKernels();
+
+template <> const FFTKernelTable<float> &FFTKernels<float>();
+template <> const FFTKernelTable<double> &FFTKernels<double>();
+
+//force a lower instruction set level for both precisions, e.g. for benchmarking. Returns false
+//if the CPU does not support the requested level
+bool FFTSelectKernels(int instrset);
+
+#endif // FFTDISPATCH_H
@@ -0,0 +1,13 @@
+// AVX build of the SIMD kernels, compile with -mavx
+#include "FFTVecIncludes.h"
+
+namespace fft_avx
+{
+#include "FFTVecKernels.h"
+}
+
+#if INSTRSET != 7
+#error "FFTKernelsAVX.cpp must be compiled with -mavx"
+#endif
+
+FFT_KERNEL_TABLE(AVX, fft_avx);
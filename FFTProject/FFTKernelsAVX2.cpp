@@ -0,0 +1,13 @@
+// AVX2 build of the SIMD kernels, compile with -mavx2
+#include "FFTVecIncludes.h"
+
+namespace fft_avx2
+{
+#include "FFTVecKernels.h"
+}
+
+#if INSTRSET != 8
+#error "FFTKernelsAVX2.cpp must be compiled with -mavx2"
+#endif
+
+FFT_KERNEL_TABLE(AVX2, fft_avx2);
@@ -0,0 +1,13 @@
+// AVX2 + FMA3 build of the SIMD kernels, compile with -mavx2 -mfma
+#include "FFTVecIncludes.h"
+
+namespace fft_fma3
+{
+#include "FFTVecKernels.h"
+}
+
+#if INSTRSET != 8 || !defined(__FMA__)
+#error "FFTKernelsFMA3.cpp must be compiled with -mavx2 -mfma"
+#endif
+
+FFT_KERNEL_TABLE(FMA3, fft_fma3);
@@ -0,0 +1,13 @@
+// SSE2 build of the SIMD kernels, compile with -msse2
+#include "FFTVecIncludes.h"
+
+namespace fft_sse2
+{
+#include "FFTVecKernels.h"
+}
+
+#if INSTRSET < 2 || INSTRSET >= 7
+#error "FFTKernelsSSE2.cpp must be compiled with -msse2"
+#endif
+
+FFT_KERNEL_TABLE(SSE2, fft_sse2);
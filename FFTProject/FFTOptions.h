@@ -0,0 +1,29 @@
+#ifndef FFTOPTIONS_H
+#define FFTOPTIONS_H
+
+#include <cmath>
+
+//transform directions for FFTInit, any positive value is forward
+const int FFT_FORWARD = 1;
+const int FFT_INVERSE = -1;
+
+//output scaling of a plan. The engines fold it into one of their passes,
+//so a normalized transform costs no extra sweep over the data
+enum FFTNormalization
+{
+    FFT_NORMALIZE_NONE,     //sum over the inputs, the inverse returns N * x
+    FFT_NORMALIZE_N,        //1 / N, the usual choice for inverse transforms
+    FFT_NORMALIZE_SQRT_N    //1 / sqrt(N) in both directions, unitary transform
+};
+
+inline double FFTNormalizationScale(FFTNormalization normalization, int length)
+{
+    switch (normalization)
+    {
+        case FFT_NORMALIZE_N:      return 1.0 / length;
+        case FFT_NORMALIZE_SQRT_N: return 1.0 / sqrt((double)length);
+        default:                   return 1.0;
+    }
+}
+
+#endif // FFTOPTIONS_H
@@ -0,0 +1,19 @@
+#ifndef FFTVECINCLUDES_H
+#define FFTVECINCLUDES_H
+
+// System and shared headers of FFTVecKernels.h. The FFTKernels*.cpp units include
+// this at global scope, before FFTVecKernels.h is included inside their own namespace,
+// so that only vectorclass and the kernels end up in that namespace.
+#include <cmath>
+#include <stdlib.h>
+#include <stdint.h>
+#ifdef __GNUC__
+#include <x86intrin.h>
+#else
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+#include "Complex.h"
+#include "FFTDispatch.h"
+
+#endif // FFTVECINCLUDES_H
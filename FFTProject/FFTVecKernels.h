@@ -0,0 +1,1892 @@
+#ifndef FFTVECKERNELS_H
+#define FFTVECKERNELS_H
+
+#include <cmath>
+#include "Complex.h"
+#include "FFTDispatch.h"
+//vectorclass calls abs(int), which its own abs overloads would hide inside the unit's namespace
+using ::abs;
+#include "vectorclass.h"
+
+// SIMD butterfly kernels shared by FFTransformerVec and FFTransformerRecursive.
+// Every vector register is handled as a set of 128-bit lanes, each holding two
+// interleaved complexes {re, im, re, im}. Vec4f has one such lane, Vec8f has two,
+// so the same kernel code works for SSE and AVX builds. The double precision
+// kernels use Vec4d as a single lane of the same layout; vectorclass emulates it
+// with two Vec2d halves on SSE2 builds.
+// This header is only included by the FFTKernels*.cpp units, which are compiled
+// once per instruction set. Each unit includes FFTVecIncludes.h first and then this
+// header, and with it vectorclass, inside a namespace of its own: the inline members
+// of vectorclass are weak symbols wherever they are not inlined (e.g. at -O0), and
+// the linker would otherwise keep one copy of them for all instruction sets. See FFTDispatch.h.
+
+template <class V>
+struct FFTVecTraits;
+
+template <>
+struct FFTVecTraits<Vec4f>
+{
+    typedef float FLOAT;
+    enum { COMPLEXES = 2 };
+};
+
+//permutation and sign change applied to every 128-bit lane
+template <int i0, int i1, int i2, int i3>
+static inline Vec4f lanePermute(Vec4f const & a)
+{
+    return permute4f<i0, i1, i2, i3>(a);
+}
+
+template <int i0, int i1, int i2, int i3>
+static inline Vec4f laneChangeSign(Vec4f const & a)
+{
+    return change_sign<i0, i1, i2, i3>(a);
+}
+
+//blend of two vectors, indexes 4..7 select from the second one
+template <int i0, int i1, int i2, int i3>
+static inline Vec4f laneBlend(Vec4f const & a, Vec4f const & b)
+{
+    return blend4f<i0, i1, i2, i3>(a, b);
+}
+
+//data loads and stores: one register covers consecutive complexes. Unaligned, as for
+//Vec4d and Vec8f: the steps read and write the user's in and out, which are only
+//8 byte aligned. Free on aligned data on every CPU since Nehalem
+static inline void loadData(Vec4f & a, const Complex<float> *p)
+{
+    a.load((const float*)p);
+}
+
+static inline void storeData(Vec4f const & a, Complex<float> *p)
+{
+    a.store((float*)p);
+}
+
+//complexes in reverse order over the whole register
+static inline Vec4f reverseComplexes(Vec4f const & a)
+{
+    return permute4f<2, 3, 0, 1>(a);
+}
+
+//first pass loads: every lane takes two complexes from its own 8-point block
+static inline void loadBlocks(Vec4f & a, const Complex<float> *p)
+{
+    a.load((const float*)p);
+}
+
+static inline void storeBlocks(Vec4f const & a, Complex<float> *p)
+{
+    a.store((float*)p);
+}
+
+//first pass loads of an out of place transform: the complexes of a block are
+//read from src[perm[0] * stride], src[perm[1] * stride], ... instead of consecutive addresses
+static inline void gatherBlocks(Vec4f & a, const Complex<float> *src, const uint *perm, int stride)
+{
+    __m128 t = _mm_loadl_pi(_mm_setzero_ps(), (const __m64*)&src[(size_t)perm[0] * stride]);
+    a = _mm_loadh_pi(t, (const __m64*)&src[(size_t)perm[1] * stride]);
+}
+
+template <>
+struct FFTVecTraits<Vec4d>
+{
+    typedef double FLOAT;
+    enum { COMPLEXES = 2 };
+};
+
+template <int i0, int i1, int i2, int i3>
+static inline Vec4d lanePermute(Vec4d const & a)
+{
+    return permute4d<i0, i1, i2, i3>(a);
+}
+
+template <int i0, int i1, int i2, int i3>
+static inline Vec4d laneChangeSign(Vec4d const & a)
+{
+    return change_sign<i0, i1, i2, i3>(a);
+}
+
+template <int i0, int i1, int i2, int i3>
+static inline Vec4d laneBlend(Vec4d const & a, Vec4d const & b)
+{
+    return blend4d<i0, i1, i2, i3>(a, b);
+}
+
+static inline Vec4d reverseComplexes(Vec4d const & a)
+{
+    return permute4d<2, 3, 0, 1>(a);
+}
+
+//new[] only aligns Complex<double> to 16 bytes
+static inline void loadData(Vec4d & a, const Complex<double> *p)
+{
+    a.load((const double*)p);
+}
+
+static inline void storeData(Vec4d const & a, Complex<double> *p)
+{
+    a.store((double*)p);
+}
+
+static inline void loadBlocks(Vec4d & a, const Complex<double> *p)
+{
+    a.load((const double*)p);
+}
+
+static inline void storeBlocks(Vec4d const & a, Complex<double> *p)
+{
+    a.store((double*)p);
+}
+
+static inline void gatherBlocks(Vec4d & a, const Complex<double> *src, const uint *perm, int stride)
+{
+    a = Vec4d(Vec2d().load((const double*)&src[(size_t)perm[0] * stride]),
+              Vec2d().load((const double*)&src[(size_t)perm[1] * stride]));
+}
+
+#if INSTRSET >= 7
+template <>
+struct FFTVecTraits<Vec8f>
+{
+    typedef float FLOAT;
+    enum { COMPLEXES = 4 };
+};
+
+template <int i0, int i1, int i2, int i3>
+static inline Vec8f lanePermute(Vec8f const & a)
+{
+    return permute8f<i0, i1, i2, i3, i0 + 4, i1 + 4, i2 + 4, i3 + 4>(a);
+}
+
+template <int i0, int i1, int i2, int i3>
+static inline Vec8f laneChangeSign(Vec8f const & a)
+{
+    return change_sign<i0, i1, i2, i3, i0, i1, i2, i3>(a);
+}
+
+template <int i0, int i1, int i2, int i3>
+static inline Vec8f laneBlend(Vec8f const & a, Vec8f const & b)
+{
+    return blend8f<(i0 < 4 ? i0 : i0 + 4), (i1 < 4 ? i1 : i1 + 4), (i2 < 4 ? i2 : i2 + 4), (i3 < 4 ? i3 : i3 + 4),
+                   (i0 < 4 ? i0 : i0 + 4) + 4, (i1 < 4 ? i1 : i1 + 4) + 4, (i2 < 4 ? i2 : i2 + 4) + 4, (i3 < 4 ? i3 : i3 + 4) + 4>(a, b);
+}
+
+static inline Vec8f reverseComplexes(Vec8f const & a)
+{
+    return permute8f<6, 7, 4, 5, 2, 3, 0, 1>(a);
+}
+
+//user data is only guaranteed to be 8 byte aligned, unaligned access is free on AVX
+static inline void loadData(Vec8f & a, const Complex<float> *p)
+{
+    a.load((const float*)p);
+}
+
+static inline void storeData(Vec8f const & a, Complex<float> *p)
+{
+    a.store((float*)p);
+}
+
+static inline void loadBlocks(Vec8f & a, const Complex<float> *p)
+{
+    a = Vec8f(Vec4f().load((const float*)p), Vec4f().load((const float*)(p + 8)));
+}
+
+static inline void storeBlocks(Vec8f const & a, Complex<float> *p)
+{
+    a.get_low().store((float*)p);
+    a.get_high().store((float*)(p + 8));
+}
+
+static inline void gatherBlocks(Vec8f & a, const Complex<float> *src, const uint *perm, int stride)
+{
+    Vec4f lo, hi;
+    gatherBlocks(lo, src, perm, stride);
+    gatherBlocks(hi, src, perm + 8, stride);
+    a = Vec8f(lo, hi);
+}
+#endif // INSTRSET >= 7
+
+//a * b + c, fused into one instruction on FMA3 builds
+static inline Vec4f mulAdd(Vec4f const & a, Vec4f const & b, Vec4f const & c)
+{
+#ifdef __FMA__
+    return _mm_fmadd_ps(a, b, c);
+#else
+    return a * b + c;
+#endif
+}
+
+#if INSTRSET >= 7
+static inline Vec8f mulAdd(Vec8f const & a, Vec8f const & b, Vec8f const & c)
+{
+#ifdef __FMA__
+    return _mm256_fmadd_ps(a, b, c);
+#else
+    return a * b + c;
+#endif
+}
+#endif // INSTRSET >= 7
+
+static inline Vec4d mulAdd(Vec4d const & a, Vec4d const & b, Vec4d const & c)
+{
+#if defined(__FMA__) && INSTRSET >= 7
+    return _mm256_fmadd_pd(a, b, c);
+#else
+    return a * b + c;
+#endif
+}
+
+//constant repeated in every 128-bit lane
+template <class V>
+static inline V laneConst(typename FFTVecTraits<V>::FLOAT a, typename FFTVecTraits<V>::FLOAT b,
+                          typename FFTVecTraits<V>::FLOAT c, typename FFTVecTraits<V>::FLOAT d);
+
+template <>
+inline Vec4f laneConst<Vec4f>(float a, float b, float c, float d)
+{
+    return Vec4f(a, b, c, d);
+}
+
+template <>
+inline Vec4d laneConst<Vec4d>(double a, double b, double c, double d)
+{
+    return Vec4d(a, b, c, d);
+}
+
+#if INSTRSET >= 7
+template <>
+inline Vec8f laneConst<Vec8f>(float a, float b, float c, float d)
+{
+    return Vec8f(a, b, c, d, a, b, c, d);
+}
+#endif // INSTRSET >= 7
+
+//explicit first steep with singular twiddles: radix-8 butterflies on bit reversed data.
+//The inverse (direction == 0) runs the forward butterflies on conjugated data,
+//conj(F(conj(x))) has the conjugated twiddles. The outputs are multiplied by
+//scale, the plan normalization is folded in here. With src given the pass is
+//also the bit reversal: data[i] is read from src[perm[i] * stride], src is left untouched
+template <class V, class FLOAT>
+static inline void fftFirstPassT(Complex<FLOAT> *data, int length, int direction, FLOAT scale,
+                                 const Complex<FLOAT> *src = 0, const uint *perm = 0, int stride = 1)
+{
+    const int blocks = FFTVecTraits<V>::COMPLEXES / 2;
+    const V sc = laneConst<V>(scale, scale, scale, scale);
+    const FLOAT SQRT2_2 = 0.70710678118654752440084436210485;
+    const V sqrt2_4f_1 = laneConst<V>(0.5,  0.5,  SQRT2_2,  SQRT2_2);
+    const V sqrt2_4f_2 = laneConst<V>(-0.5, 0.5, -SQRT2_2, -SQRT2_2);
+    for (int butterfly = 0; butterfly < length; butterfly += 8 * blocks)
+    {
+        Complex<FLOAT> *a = &data[butterfly + 0];
+        Complex<FLOAT> *c = &data[butterfly + 2];
+        Complex<FLOAT> *e = &data[butterfly + 4];
+        Complex<FLOAT> *g = &data[butterfly + 6];
+
+        V ab, cd, ef, gh;
+        if (src != 0)
+        {
+            gatherBlocks(ab, src, perm + butterfly + 0, stride);
+            gatherBlocks(cd, src, perm + butterfly + 2, stride);
+            gatherBlocks(ef, src, perm + butterfly + 4, stride);
+            gatherBlocks(gh, src, perm + butterfly + 6, stride);
+        }
+        else
+        {
+            loadBlocks(ab, a);
+            loadBlocks(cd, c);
+            loadBlocks(ef, e);
+            loadBlocks(gh, g);
+        }
+        if (direction == 0)
+        {
+            ab = laneChangeSign<0,1,0,1>(ab);
+            cd = laneChangeSign<0,1,0,1>(cd);
+            ef = laneChangeSign<0,1,0,1>(ef);
+            gh = laneChangeSign<0,1,0,1>(gh);
+        }
+
+        V ab_shuf = lanePermute<2,3,0,1>(ab);
+        ab = laneChangeSign<0,0,1,1>(ab) + ab_shuf;
+        V cd_shuf = lanePermute<2,3,0,1>(cd);
+        cd = laneChangeSign<0,0,1,1>(cd) + cd_shuf;
+        V cd_rot = laneChangeSign<0,0,0,1>(lanePermute<0,1,3,2>(cd));
+        V ab_fin = ab + cd_rot;
+        V cd_fin = ab - cd_rot;
+
+        V ef_shuf = lanePermute<2,3,0,1>(ef);
+        ef = laneChangeSign<0,0,1,1>(ef) + ef_shuf;
+        V gh_shuf = lanePermute<2,3,0,1>(gh);
+        gh = laneChangeSign<0,0,1,1>(gh) + gh_shuf;
+        V gh_rot = laneChangeSign<0,0,0,1>(lanePermute<0,1,3,2>(gh));
+        V ef_fin = ef + gh_rot;
+        V gh_fin = ef - gh_rot;
+
+        V ef_fin_shuf = laneChangeSign<0,0,0,1>(lanePermute<0,1,3,2>(ef_fin));
+        ef_shuf = (ef_fin + ef_fin_shuf) * sqrt2_4f_1;
+
+        V gh_fin_shuf = laneChangeSign<0,0,1,0>(lanePermute<0,1,3,2>(gh_fin));
+        gh_fin_shuf = (gh_fin + gh_fin_shuf) * sqrt2_4f_2;
+        gh_shuf = lanePermute<1,0,2,3>(gh_fin_shuf);
+
+        ef_fin = ab_fin - ef_shuf;
+        ab_fin = ab_fin + ef_shuf;
+
+        gh_fin = cd_fin - gh_shuf;
+        cd_fin = cd_fin + gh_shuf;
+        if (direction == 0)
+        {
+            ab_fin = laneChangeSign<0,1,0,1>(ab_fin);
+            cd_fin = laneChangeSign<0,1,0,1>(cd_fin);
+            ef_fin = laneChangeSign<0,1,0,1>(ef_fin);
+            gh_fin = laneChangeSign<0,1,0,1>(gh_fin);
+        }
+        if (scale != 1)
+        {
+            ab_fin *= sc;
+            cd_fin *= sc;
+            ef_fin *= sc;
+            gh_fin *= sc;
+        }
+
+        storeBlocks(ab_fin, a);
+        storeBlocks(cd_fin, c);
+        storeBlocks(ef_fin, e);
+        storeBlocks(gh_fin, g);
+    }
+}
+
+//transforms shorter than one radix-8 block, all stages on bit reversed data
+template <class FLOAT>
+static inline void fftFirstPassSmall(Complex<FLOAT> *data, int length, int direction, FLOAT scale)
+{
+    const FLOAT rot = direction > 0 ? 1 : -1;
+    for (int i = 0; i + 1 < length; i += 2)
+    {
+        const Complex<FLOAT> a = data[i];
+        const Complex<FLOAT> b = data[i + 1];
+        data[i].re = a.re + b.re;
+        data[i].im = a.im + b.im;
+        data[i + 1].re = a.re - b.re;
+        data[i + 1].im = a.im - b.im;
+    }
+    if (length == 4)
+    {
+        const Complex<FLOAT> a = data[0];
+        const Complex<FLOAT> c = data[2];
+        data[0].re = a.re + c.re;
+        data[0].im = a.im + c.im;
+        data[2].re = a.re - c.re;
+        data[2].im = a.im - c.im;
+        //-i * rot * data[3]
+        const Complex<FLOAT> b = data[1];
+        const FLOAT t_re = rot * data[3].im, t_im = -rot * data[3].re;
+        data[1].re = b.re + t_re;
+        data[1].im = b.im + t_im;
+        data[3].re = b.re - t_re;
+        data[3].im = b.im - t_im;
+    }
+    for (int i = 0; i < length; i++)
+    {
+        data[i].re *= scale;
+        data[i].im *= scale;
+    }
+}
+
+//twiddles split for complex multiplication: duplicated real parts and
+//sign adjusted duplicated imaginary parts
+template <class V>
+static inline void splitTwiddle(V & tw_norm, V & tw_perm, V const & tw)
+{
+    tw_perm = laneChangeSign<1,0,1,0>(lanePermute<1,1,3,3>(tw));
+    tw_norm = lanePermute<0,0,2,2>(tw);
+}
+
+template <class V, class FLOAT>
+static inline void loadTwiddle(V & tw_norm, V & tw_perm, const Complex<FLOAT> *tw)
+{
+    V t;
+    t.load_a((const FLOAT*)tw);
+    splitTwiddle(tw_norm, tw_perm, t);
+}
+
+template <class V>
+static inline V complexMul(V const & a, V const & tw_norm, V const & tw_perm)
+{
+    return mulAdd(a, tw_norm, lanePermute<1,0,3,2>(a) * tw_perm);
+}
+
+//one radix-2 stage, twiddle_number is the half size of the butterfly groups.
+//tw_begin and tw_end limit it to those butterflies of every group, tw_end 0 means all
+template <class V, class FLOAT>
+static inline void fftTwiddlePassT(Complex<FLOAT> *data, int length, int twiddle_number, const Complex<FLOAT> *twiddles,
+                                   int tw_begin = 0, int tw_end = 0)
+{
+    const int C = FFTVecTraits<V>::COMPLEXES;
+    int steep = twiddle_number * 2;
+    if (tw_end == 0) tw_end = twiddle_number;
+    for (int twiddle = tw_begin; twiddle < tw_end; twiddle += 2 * C)
+    {
+        const Complex<FLOAT> *tw = &twiddles[twiddle_number + twiddle - 4];
+        V tw_norm_1, tw_perm_1, tw_norm_2, tw_perm_2;
+        loadTwiddle(tw_norm_1, tw_perm_1, tw);
+        loadTwiddle(tw_norm_2, tw_perm_2, tw + C);
+
+        for (int butterfly = twiddle; butterfly < length; butterfly += steep)
+        {
+            Complex<FLOAT> *a = &data[butterfly];
+            Complex<FLOAT> *b = &data[butterfly + twiddle_number];
+            Complex<FLOAT> *e = &data[butterfly + C];
+            Complex<FLOAT> *g = &data[butterfly + C + twiddle_number];
+
+            V ac, bd, ef, gh;
+            loadData(ac, a);
+            loadData(bd, b);
+            loadData(ef, e);
+            loadData(gh, g);
+
+            V uv_bd = complexMul(bd, tw_norm_1, tw_perm_1);
+            bd = ac - uv_bd;
+            ac = ac + uv_bd;
+
+            V uv_gh = complexMul(gh, tw_norm_2, tw_perm_2);
+            gh = ef - uv_gh;
+            ef = ef + uv_gh;
+
+            storeData(ac, a);
+            storeData(bd, b);
+            storeData(ef, e);
+            storeData(gh, g);
+        }
+    }
+}
+
+//two radix-2 stages (twiddle_number and 2 * twiddle_number) fused into one pass
+template <class V, class FLOAT>
+static inline void fftTwiddlePass4T(Complex<FLOAT> *data, int length, int twiddle_number, const Complex<FLOAT> *twiddles)
+{
+    const int C = FFTVecTraits<V>::COMPLEXES;
+    const int m = twiddle_number;
+    int steep = m * 4;
+    for (int twiddle = 0; twiddle < m; twiddle += C)
+    {
+        V tw1_norm, tw1_perm, tw2_norm, tw2_perm, tw3_norm, tw3_perm;
+        loadTwiddle(tw1_norm, tw1_perm, &twiddles[m + twiddle - 4]);
+        loadTwiddle(tw2_norm, tw2_perm, &twiddles[2 * m + twiddle - 4]);
+        loadTwiddle(tw3_norm, tw3_perm, &twiddles[3 * m + twiddle - 4]);
+
+        for (int butterfly = twiddle; butterfly < length; butterfly += steep)
+        {
+            Complex<FLOAT> *p = &data[butterfly];
+            V x0, x1, x2, x3;
+            loadData(x0, p);
+            loadData(x1, p + m);
+            loadData(x2, p + 2 * m);
+            loadData(x3, p + 3 * m);
+
+            V t = complexMul(x1, tw1_norm, tw1_perm);
+            x1 = x0 - t;
+            x0 = x0 + t;
+            t  = complexMul(x3, tw1_norm, tw1_perm);
+            x3 = x2 - t;
+            x2 = x2 + t;
+
+            t  = complexMul(x2, tw2_norm, tw2_perm);
+            x2 = x0 - t;
+            x0 = x0 + t;
+            t  = complexMul(x3, tw3_norm, tw3_perm);
+            x3 = x1 - t;
+            x1 = x1 + t;
+
+            storeData(x0, p);
+            storeData(x1, p + m);
+            storeData(x2, p + 2 * m);
+            storeData(x3, p + 3 * m);
+        }
+    }
+}
+
+//three radix-2 stages (twiddle_number, 2 * and 4 * twiddle_number) fused into one pass
+template <class V, class FLOAT>
+static inline void fftTwiddlePass8T(Complex<FLOAT> *data, int length, int twiddle_number, const Complex<FLOAT> *twiddles)
+{
+    const int C = FFTVecTraits<V>::COMPLEXES;
+    const int m = twiddle_number;
+    int steep = m * 8;
+    for (int twiddle = 0; twiddle < m; twiddle += C)
+    {
+        //twiddles are reloaded per butterfly, 14 prepared registers would only spill
+        const Complex<FLOAT> *tw1 = &twiddles[m + twiddle - 4];
+        const Complex<FLOAT> *tw2 = &twiddles[2 * m + twiddle - 4];
+        const Complex<FLOAT> *tw4 = &twiddles[4 * m + twiddle - 4];
+
+        for (int butterfly = twiddle; butterfly < length; butterfly += steep)
+        {
+            Complex<FLOAT> *p = &data[butterfly];
+            V x0, x1, x2, x3, x4, x5, x6, x7, tw_norm, tw_perm, t;
+            loadData(x0, p);
+            loadData(x1, p + m);
+            loadData(x2, p + 2 * m);
+            loadData(x3, p + 3 * m);
+            loadData(x4, p + 4 * m);
+            loadData(x5, p + 5 * m);
+            loadData(x6, p + 6 * m);
+            loadData(x7, p + 7 * m);
+
+            loadTwiddle(tw_norm, tw_perm, tw1);
+            t = complexMul(x1, tw_norm, tw_perm);  x1 = x0 - t;  x0 = x0 + t;
+            t = complexMul(x3, tw_norm, tw_perm);  x3 = x2 - t;  x2 = x2 + t;
+            t = complexMul(x5, tw_norm, tw_perm);  x5 = x4 - t;  x4 = x4 + t;
+            t = complexMul(x7, tw_norm, tw_perm);  x7 = x6 - t;  x6 = x6 + t;
+
+            loadTwiddle(tw_norm, tw_perm, tw2);
+            t = complexMul(x2, tw_norm, tw_perm);  x2 = x0 - t;  x0 = x0 + t;
+            t = complexMul(x6, tw_norm, tw_perm);  x6 = x4 - t;  x4 = x4 + t;
+            loadTwiddle(tw_norm, tw_perm, tw2 + m);
+            t = complexMul(x3, tw_norm, tw_perm);  x3 = x1 - t;  x1 = x1 + t;
+            t = complexMul(x7, tw_norm, tw_perm);  x7 = x5 - t;  x5 = x5 + t;
+
+            loadTwiddle(tw_norm, tw_perm, tw4);
+            t = complexMul(x4, tw_norm, tw_perm);  x4 = x0 - t;  x0 = x0 + t;
+            loadTwiddle(tw_norm, tw_perm, tw4 + m);
+            t = complexMul(x5, tw_norm, tw_perm);  x5 = x1 - t;  x1 = x1 + t;
+            loadTwiddle(tw_norm, tw_perm, tw4 + 2 * m);
+            t = complexMul(x6, tw_norm, tw_perm);  x6 = x2 - t;  x2 = x2 + t;
+            loadTwiddle(tw_norm, tw_perm, tw4 + 3 * m);
+            t = complexMul(x7, tw_norm, tw_perm);  x7 = x3 - t;  x3 = x3 + t;
+
+            storeData(x0, p);
+            storeData(x1, p + m);
+            storeData(x2, p + 2 * m);
+            storeData(x3, p + 3 * m);
+            storeData(x4, p + 4 * m);
+            storeData(x5, p + 5 * m);
+            storeData(x6, p + 6 * m);
+            storeData(x7, p + 7 * m);
+        }
+    }
+}
+
+//Stockham steps take the normalization of the plan as scale, it is folded
+//into the twiddles and the untwiddled first output
+template <class FLOAT>
+static inline Complex<FLOAT> scaleTwiddle(const Complex<FLOAT> & w, FLOAT scale)
+{
+    Complex<FLOAT> r;
+    r.re = w.re * scale;
+    r.im = w.im * scale;
+    return r;
+}
+
+//Stockham autosort steps, see FFTransformerStockham. A step of radix r reads
+//x[q + s * (p + j * m)] and writes y[q + s * (r * p + k)], m = n / r. The
+//twiddles of a step are stored as w1[m], w2[m], w3[m] with w_k[p] = W_n^(k * p).
+//The last step (m = 1) may run in place.
+template <class FLOAT>
+static inline void stockhamPass4Scalar(const Complex<FLOAT> *x, Complex<FLOAT> *y, int n, int s, const Complex<FLOAT> *twiddles, int direction, FLOAT scale)
+{
+    const int m = n / 4;
+    const FLOAT rot = direction > 0 ? 1 : -1;
+    for (int p = 0; p < m; p++)
+    {
+        const Complex<FLOAT> w1 = scaleTwiddle(twiddles[p], scale);
+        const Complex<FLOAT> w2 = scaleTwiddle(twiddles[p + m], scale);
+        const Complex<FLOAT> w3 = scaleTwiddle(twiddles[p + 2 * m], scale);
+        for (int q = 0; q < s; q++)
+        {
+            const Complex<FLOAT> a = x[q + s * (p + 0 * m)];
+            const Complex<FLOAT> b = x[q + s * (p + 1 * m)];
+            const Complex<FLOAT> c = x[q + s * (p + 2 * m)];
+            const Complex<FLOAT> d = x[q + s * (p + 3 * m)];
+
+            FLOAT apc_re = a.re + c.re, apc_im = a.im + c.im;
+            FLOAT amc_re = a.re - c.re, amc_im = a.im - c.im;
+            FLOAT bpd_re = b.re + d.re, bpd_im = b.im + d.im;
+            //i * rot * (b - d)
+            FLOAT jbmd_re = -rot * (b.im - d.im), jbmd_im = rot * (b.re - d.re);
+
+            FLOAT u_re, u_im;
+            Complex<FLOAT> *out = &y[q + s * 4 * p];
+            out[0].re = (apc_re + bpd_re) * scale;
+            out[0].im = (apc_im + bpd_im) * scale;
+            u_re = amc_re - jbmd_re;
+            u_im = amc_im - jbmd_im;
+            out[s].re = u_re * w1.re - u_im * w1.im;
+            out[s].im = u_re * w1.im + u_im * w1.re;
+            u_re = apc_re - bpd_re;
+            u_im = apc_im - bpd_im;
+            out[2 * s].re = u_re * w2.re - u_im * w2.im;
+            out[2 * s].im = u_re * w2.im + u_im * w2.re;
+            u_re = amc_re + jbmd_re;
+            u_im = amc_im + jbmd_im;
+            out[3 * s].re = u_re * w3.re - u_im * w3.im;
+            out[3 * s].im = u_re * w3.im + u_im * w3.re;
+        }
+    }
+}
+
+template <class FLOAT>
+static inline void stockhamPass2Scalar(const Complex<FLOAT> *x, Complex<FLOAT> *y, int n, int s, const Complex<FLOAT> *twiddles, FLOAT scale)
+{
+    const int m = n / 2;
+    for (int p = 0; p < m; p++)
+    {
+        const Complex<FLOAT> w = scaleTwiddle(twiddles[p], scale);
+        for (int q = 0; q < s; q++)
+        {
+            const Complex<FLOAT> a = x[q + s * p];
+            const Complex<FLOAT> b = x[q + s * (p + m)];
+            FLOAT u_re = a.re - b.re;
+            FLOAT u_im = a.im - b.im;
+            Complex<FLOAT> *out = &y[q + s * 2 * p];
+            out[0].re = (a.re + b.re) * scale;
+            out[0].im = (a.im + b.im) * scale;
+            out[s].re = u_re * w.re - u_im * w.im;
+            out[s].im = u_re * w.im + u_im * w.re;
+        }
+    }
+}
+
+//twiddle broadcast to every complex of the vector
+template <class V, class FLOAT>
+static inline void broadcastTwiddle(V & tw_norm, V & tw_perm, const Complex<FLOAT> & w, FLOAT scale)
+{
+    const FLOAT re = w.re * scale, im = w.im * scale;
+    tw_norm = laneConst<V>(re, re, re, re);
+    tw_perm = laneConst<V>(-im, im, -im, im);
+}
+
+template <class V, class FLOAT>
+static inline void stockhamPass4T(const Complex<FLOAT> *x, Complex<FLOAT> *y, int n, int s, const Complex<FLOAT> *twiddles, int direction, FLOAT scale)
+{
+    const int C = FFTVecTraits<V>::COMPLEXES;
+    const int m = n / 4;
+    const FLOAT rot = direction > 0 ? 1 : -1;
+    const V rot_sign = laneConst<V>(-rot, rot, -rot, rot);
+    const V sc = laneConst<V>(scale, scale, scale, scale);
+    if (s % C == 0)
+    {
+        //vectorized over q, the twiddle is the same for the whole vector
+        for (int p = 0; p < m; p++)
+        {
+            V tw1_norm, tw1_perm, tw2_norm, tw2_perm, tw3_norm, tw3_perm;
+            broadcastTwiddle(tw1_norm, tw1_perm, twiddles[p], scale);
+            broadcastTwiddle(tw2_norm, tw2_perm, twiddles[p + m], scale);
+            broadcastTwiddle(tw3_norm, tw3_perm, twiddles[p + 2 * m], scale);
+            for (int q = 0; q < s; q += C)
+            {
+                V a, b, c, d;
+                loadData(a, &x[q + s * (p + 0 * m)]);
+                loadData(b, &x[q + s * (p + 1 * m)]);
+                loadData(c, &x[q + s * (p + 2 * m)]);
+                loadData(d, &x[q + s * (p + 3 * m)]);
+
+                V apc = a + c;
+                V amc = a - c;
+                V bpd = b + d;
+                V jbmd = lanePermute<1,0,3,2>(b - d) * rot_sign;
+
+                Complex<FLOAT> *out = &y[q + s * 4 * p];
+                storeData((apc + bpd) * sc, out);
+                storeData(complexMul(amc - jbmd, tw1_norm, tw1_perm), out + s);
+                storeData(complexMul(apc - bpd, tw2_norm, tw2_perm), out + 2 * s);
+                storeData(complexMul(amc + jbmd, tw3_norm, tw3_perm), out + 3 * s);
+            }
+        }
+    }
+    else if (s == 1 && m % C == 0)
+    {
+        //first step: vectorized over p, the four outputs of every p are interleaved on store
+        for (int p = 0; p < m; p += C)
+        {
+            V a, b, c, d, tw_norm, tw_perm;
+            loadData(a, &x[p + 0 * m]);
+            loadData(b, &x[p + 1 * m]);
+            loadData(c, &x[p + 2 * m]);
+            loadData(d, &x[p + 3 * m]);
+
+            V apc = a + c;
+            V amc = a - c;
+            V bpd = b + d;
+            V jbmd = lanePermute<1,0,3,2>(b - d) * rot_sign;
+
+            V r0 = apc + bpd;
+            loadTwiddle(tw_norm, tw_perm, &twiddles[p]);
+            V r1 = complexMul(amc - jbmd, tw_norm, tw_perm);
+            loadTwiddle(tw_norm, tw_perm, &twiddles[p + m]);
+            V r2 = complexMul(apc - bpd, tw_norm, tw_perm);
+            loadTwiddle(tw_norm, tw_perm, &twiddles[p + 2 * m]);
+            V r3 = complexMul(amc + jbmd, tw_norm, tw_perm);
+            if (scale != 1)
+            {
+                r0 *= sc;
+                r1 *= sc;
+                r2 *= sc;
+                r3 *= sc;
+            }
+
+            Complex<FLOAT> *out = &y[4 * p];
+            storeBlocks(laneBlend<0,1,4,5>(r0, r1), out);
+            storeBlocks(laneBlend<0,1,4,5>(r2, r3), out + 2);
+            storeBlocks(laneBlend<2,3,6,7>(r0, r1), out + 4);
+            storeBlocks(laneBlend<2,3,6,7>(r2, r3), out + 6);
+        }
+    }
+    else
+    {
+        stockhamPass4Scalar(x, y, n, s, twiddles, direction, scale);
+    }
+}
+
+template <class V, class FLOAT>
+static inline void stockhamPass2T(const Complex<FLOAT> *x, Complex<FLOAT> *y, int n, int s, const Complex<FLOAT> *twiddles, FLOAT scale)
+{
+    const int C = FFTVecTraits<V>::COMPLEXES;
+    const int m = n / 2;
+    const V sc = laneConst<V>(scale, scale, scale, scale);
+    if (s % C != 0)
+    {
+        stockhamPass2Scalar(x, y, n, s, twiddles, scale);
+        return;
+    }
+    for (int p = 0; p < m; p++)
+    {
+        V tw_norm, tw_perm;
+        broadcastTwiddle(tw_norm, tw_perm, twiddles[p], scale);
+        for (int q = 0; q < s; q += C)
+        {
+            V a, b;
+            loadData(a, &x[q + s * p]);
+            loadData(b, &x[q + s * (p + m)]);
+            Complex<FLOAT> *out = &y[q + s * 2 * p];
+            storeData((a + b) * sc, out);
+            storeData(complexMul(a - b, tw_norm, tw_perm), out + s);
+        }
+    }
+}
+
+//odd radix Stockham step, radix 3, 5 or 7, same layout with w1..w(r-1).
+//Inputs j and r - j are paired: with a_j = x_j + x_(r-j), b_j = x_j - x_(r-j)
+//the outputs k and r - k are x_0 + sum a_j cos(2 pi jk / r) -+ i * rot * sum b_j sin(2 pi jk / r)
+template <class FLOAT>
+static inline void stockhamPassOddScalar(const Complex<FLOAT> *x, Complex<FLOAT> *y, int n, int s, int radix, const Complex<FLOAT> *twiddles, int direction, FLOAT scale)
+{
+    const int m = n / radix;
+    const int half = radix / 2;
+    const FLOAT rot = direction > 0 ? 1 : -1;
+    FLOAT cs[4][4], sn[4][4];
+    for (int j = 1; j <= half; j++)
+    {
+        for (int k = 1; k <= half; k++)
+        {
+            cs[j][k] = cos(2 * M_PI * j * k / radix);
+            sn[j][k] = sin(2 * M_PI * j * k / radix);
+        }
+    }
+    for (int p = 0; p < m; p++)
+    {
+        for (int q = 0; q < s; q++)
+        {
+            Complex<FLOAT> x0 = x[q + s * p];
+            Complex<FLOAT> a[4], b[4], out[8];
+            out[0] = x0;
+            for (int j = 1; j <= half; j++)
+            {
+                const Complex<FLOAT> u = x[q + s * (p + j * m)];
+                const Complex<FLOAT> v = x[q + s * (p + (radix - j) * m)];
+                a[j].re = u.re + v.re;
+                a[j].im = u.im + v.im;
+                b[j].re = u.re - v.re;
+                b[j].im = u.im - v.im;
+                out[0].re += a[j].re;
+                out[0].im += a[j].im;
+            }
+            for (int k = 1; k <= half; k++)
+            {
+                FLOAT u_re = x0.re, u_im = x0.im, t_re = 0, t_im = 0;
+                for (int j = 1; j <= half; j++)
+                {
+                    u_re += a[j].re * cs[j][k];
+                    u_im += a[j].im * cs[j][k];
+                    t_re += b[j].re * sn[j][k];
+                    t_im += b[j].im * sn[j][k];
+                }
+                //i * rot * t
+                FLOAT jt_re = -rot * t_im, jt_im = rot * t_re;
+                out[k].re = u_re - jt_re;
+                out[k].im = u_im - jt_im;
+                out[radix - k].re = u_re + jt_re;
+                out[radix - k].im = u_im + jt_im;
+            }
+            Complex<FLOAT> *dst = &y[q + s * radix * p];
+            dst[0].re = out[0].re * scale;
+            dst[0].im = out[0].im * scale;
+            for (int k = 1; k < radix; k++)
+            {
+                const Complex<FLOAT> w = scaleTwiddle(twiddles[(k - 1) * m + p], scale);
+                dst[k * s].re = out[k].re * w.re - out[k].im * w.im;
+                dst[k * s].im = out[k].re * w.im + out[k].im * w.re;
+            }
+        }
+    }
+}
+
+//vectorized over q, needs s % C == 0. All inputs of a butterfly are loaded
+//before the first store, so the last step can run in place
+template <class V, int R, class FLOAT>
+static inline void stockhamPassOddT(const Complex<FLOAT> *x, Complex<FLOAT> *y, int n, int s, const Complex<FLOAT> *twiddles, int direction, FLOAT scale)
+{
+    const int C = FFTVecTraits<V>::COMPLEXES;
+    const int H = R / 2;
+    const int m = n / R;
+    const FLOAT rot = direction > 0 ? 1 : -1;
+    const V rot_sign = laneConst<V>(-rot, rot, -rot, rot);
+    const V sc = laneConst<V>(scale, scale, scale, scale);
+    V cs[H + 1][H + 1], sn[H + 1][H + 1];
+    for (int j = 1; j <= H; j++)
+    {
+        for (int k = 1; k <= H; k++)
+        {
+            FLOAT c = cos(2 * M_PI * j * k / R);
+            FLOAT d = sin(2 * M_PI * j * k / R);
+            cs[j][k] = laneConst<V>(c, c, c, c);
+            sn[j][k] = laneConst<V>(d, d, d, d);
+        }
+    }
+    for (int p = 0; p < m; p++)
+    {
+        V tw_norm[R], tw_perm[R];
+        for (int k = 1; k < R; k++)
+        {
+            broadcastTwiddle(tw_norm[k], tw_perm[k], twiddles[(k - 1) * m + p], scale);
+        }
+        for (int q = 0; q < s; q += C)
+        {
+            V x0, a[H + 1], b[H + 1], out[R];
+            loadData(x0, &x[q + s * p]);
+            out[0] = x0;
+            for (int j = 1; j <= H; j++)
+            {
+                V u, v;
+                loadData(u, &x[q + s * (p + j * m)]);
+                loadData(v, &x[q + s * (p + (R - j) * m)]);
+                a[j] = u + v;
+                b[j] = u - v;
+                out[0] += a[j];
+            }
+            for (int k = 1; k <= H; k++)
+            {
+                V u = mulAdd(a[1], cs[1][k], x0);
+                V t = b[1] * sn[1][k];
+                for (int j = 2; j <= H; j++)
+                {
+                    u = mulAdd(a[j], cs[j][k], u);
+                    t = mulAdd(b[j], sn[j][k], t);
+                }
+                V jt = lanePermute<1,0,3,2>(t) * rot_sign;
+                out[k] = u - jt;
+                out[R - k] = u + jt;
+            }
+            Complex<FLOAT> *dst = &y[q + s * R * p];
+            storeData(out[0] * sc, dst);
+            for (int k = 1; k < R; k++)
+            {
+                storeData(complexMul(out[k], tw_norm[k], tw_perm[k]), dst + k * s);
+            }
+        }
+    }
+}
+
+template <class V, class FLOAT>
+static inline void stockhamPassOddRadix(const Complex<FLOAT> *x, Complex<FLOAT> *y, int n, int s, int radix, const Complex<FLOAT> *twiddles, int direction, FLOAT scale)
+{
+    switch (radix)
+    {
+        case 3: stockhamPassOddT<V, 3>(x, y, n, s, twiddles, direction, scale); break;
+        case 5: stockhamPassOddT<V, 5>(x, y, n, s, twiddles, direction, scale); break;
+        case 7: stockhamPassOddT<V, 7>(x, y, n, s, twiddles, direction, scale); break;
+        default: stockhamPassOddScalar(x, y, n, s, radix, twiddles, direction, scale);
+    }
+}
+
+//planar Stockham steps, see FFTransformerPlanar: the index scheme of the
+//interleaved steps on separate real and imaginary arrays, the twiddles are
+//split the same way. A vector holds 2 * COMPLEXES real or imaginary parts,
+//so the butterflies and twiddle products need no permutes at all
+template <class FLOAT>
+static inline void planarPass4Scalar(const FLOAT *xr, const FLOAT *xi, FLOAT *yr, FLOAT *yi, int n, int s, const FLOAT *tw_re, const FLOAT *tw_im, int direction, FLOAT scale)
+{
+    const int m = n / 4;
+    const FLOAT rot = direction > 0 ? 1 : -1;
+    for (int p = 0; p < m; p++)
+    {
+        const FLOAT w1_re = tw_re[p] * scale, w1_im = tw_im[p] * scale;
+        const FLOAT w2_re = tw_re[p + m] * scale, w2_im = tw_im[p + m] * scale;
+        const FLOAT w3_re = tw_re[p + 2 * m] * scale, w3_im = tw_im[p + 2 * m] * scale;
+        for (int q = 0; q < s; q++)
+        {
+            const int i = q + s * p;
+            const FLOAT a_re = xr[i], a_im = xi[i];
+            const FLOAT b_re = xr[i + s * m], b_im = xi[i + s * m];
+            const FLOAT c_re = xr[i + 2 * s * m], c_im = xi[i + 2 * s * m];
+            const FLOAT d_re = xr[i + 3 * s * m], d_im = xi[i + 3 * s * m];
+
+            FLOAT apc_re = a_re + c_re, apc_im = a_im + c_im;
+            FLOAT amc_re = a_re - c_re, amc_im = a_im - c_im;
+            FLOAT bpd_re = b_re + d_re, bpd_im = b_im + d_im;
+            //i * rot * (b - d)
+            FLOAT jbmd_re = -rot * (b_im - d_im), jbmd_im = rot * (b_re - d_re);
+
+            FLOAT u_re, u_im;
+            const int o = q + s * 4 * p;
+            yr[o] = (apc_re + bpd_re) * scale;
+            yi[o] = (apc_im + bpd_im) * scale;
+            u_re = amc_re - jbmd_re;
+            u_im = amc_im - jbmd_im;
+            yr[o + s] = u_re * w1_re - u_im * w1_im;
+            yi[o + s] = u_re * w1_im + u_im * w1_re;
+            u_re = apc_re - bpd_re;
+            u_im = apc_im - bpd_im;
+            yr[o + 2 * s] = u_re * w2_re - u_im * w2_im;
+            yi[o + 2 * s] = u_re * w2_im + u_im * w2_re;
+            u_re = amc_re + jbmd_re;
+            u_im = amc_im + jbmd_im;
+            yr[o + 3 * s] = u_re * w3_re - u_im * w3_im;
+            yi[o + 3 * s] = u_re * w3_im + u_im * w3_re;
+        }
+    }
+}
+
+template <class FLOAT>
+static inline void planarPass2Scalar(const FLOAT *xr, const FLOAT *xi, FLOAT *yr, FLOAT *yi, int n, int s, const FLOAT *tw_re, const FLOAT *tw_im, FLOAT scale)
+{
+    const int m = n / 2;
+    for (int p = 0; p < m; p++)
+    {
+        const FLOAT w_re = tw_re[p] * scale, w_im = tw_im[p] * scale;
+        for (int q = 0; q < s; q++)
+        {
+            const int i = q + s * p;
+            const FLOAT a_re = xr[i], a_im = xi[i];
+            const FLOAT b_re = xr[i + s * m], b_im = xi[i + s * m];
+            FLOAT u_re = a_re - b_re;
+            FLOAT u_im = a_im - b_im;
+            const int o = q + s * 2 * p;
+            yr[o] = (a_re + b_re) * scale;
+            yi[o] = (a_im + b_im) * scale;
+            yr[o + s] = u_re * w_re - u_im * w_im;
+            yi[o + s] = u_re * w_im + u_im * w_re;
+        }
+    }
+}
+
+//radix-4 butterfly on planar vectors, a..d are replaced by the untwiddled outputs 0..3
+template <class V>
+static inline void planarButterfly4(V & a_re, V & a_im, V & b_re, V & b_im, V & c_re, V & c_im, V & d_re, V & d_im, V const & rot)
+{
+    V apc_re = a_re + c_re, apc_im = a_im + c_im;
+    V amc_re = a_re - c_re, amc_im = a_im - c_im;
+    V bpd_re = b_re + d_re, bpd_im = b_im + d_im;
+    //i * rot * (b - d)
+    V jbmd_re = (d_im - b_im) * rot, jbmd_im = (b_re - d_re) * rot;
+    a_re = apc_re + bpd_re;
+    a_im = apc_im + bpd_im;
+    b_re = amc_re - jbmd_re;
+    b_im = amc_im - jbmd_im;
+    c_re = apc_re - bpd_re;
+    c_im = apc_im - bpd_im;
+    d_re = amc_re + jbmd_re;
+    d_im = amc_im + jbmd_im;
+}
+
+template <class V>
+static inline void planarMul(V & re, V & im, V const & w_re, V const & w_im)
+{
+    V t = re * w_im + im * w_re;
+    re = re * w_re - im * w_im;
+    im = t;
+}
+
+//4 x W transpose on store: p[4 * i + k] = rk[i], only used by the first step
+static inline void storeInterleaved4(Vec4f const & r0, Vec4f const & r1, Vec4f const & r2, Vec4f const & r3, float *p)
+{
+    Vec4f t0 = blend4f<0,4,1,5>(r0, r1);
+    Vec4f t1 = blend4f<2,6,3,7>(r0, r1);
+    Vec4f t2 = blend4f<0,4,1,5>(r2, r3);
+    Vec4f t3 = blend4f<2,6,3,7>(r2, r3);
+    blend4f<0,1,4,5>(t0, t2).store(p);
+    blend4f<2,3,6,7>(t0, t2).store(p + 4);
+    blend4f<0,1,4,5>(t1, t3).store(p + 8);
+    blend4f<2,3,6,7>(t1, t3).store(p + 12);
+}
+
+static inline void storeInterleaved4(Vec4d const & r0, Vec4d const & r1, Vec4d const & r2, Vec4d const & r3, double *p)
+{
+    Vec4d t0 = blend4d<0,4,2,6>(r0, r1);
+    Vec4d t1 = blend4d<1,5,3,7>(r0, r1);
+    Vec4d t2 = blend4d<0,4,2,6>(r2, r3);
+    Vec4d t3 = blend4d<1,5,3,7>(r2, r3);
+    blend4d<0,1,4,5>(t0, t2).store(p);
+    blend4d<0,1,4,5>(t1, t3).store(p + 4);
+    blend4d<2,3,6,7>(t0, t2).store(p + 8);
+    blend4d<2,3,6,7>(t1, t3).store(p + 12);
+}
+
+#if INSTRSET >= 7
+//4 x 4 transposes within the 128-bit lanes, then the lane halves are regrouped
+static inline void storeInterleaved4(Vec8f const & r0, Vec8f const & r1, Vec8f const & r2, Vec8f const & r3, float *p)
+{
+    Vec8f t0 = blend8f<0,8,1,9,4,12,5,13>(r0, r1);
+    Vec8f t1 = blend8f<2,10,3,11,6,14,7,15>(r0, r1);
+    Vec8f t2 = blend8f<0,8,1,9,4,12,5,13>(r2, r3);
+    Vec8f t3 = blend8f<2,10,3,11,6,14,7,15>(r2, r3);
+    Vec8f u0 = blend8f<0,1,8,9,4,5,12,13>(t0, t2);
+    Vec8f u1 = blend8f<2,3,10,11,6,7,14,15>(t0, t2);
+    Vec8f u2 = blend8f<0,1,8,9,4,5,12,13>(t1, t3);
+    Vec8f u3 = blend8f<2,3,10,11,6,7,14,15>(t1, t3);
+    blend8f<0,1,2,3,8,9,10,11>(u0, u1).store(p);
+    blend8f<0,1,2,3,8,9,10,11>(u2, u3).store(p + 8);
+    blend8f<4,5,6,7,12,13,14,15>(u0, u1).store(p + 16);
+    blend8f<4,5,6,7,12,13,14,15>(u2, u3).store(p + 24);
+}
+#endif // INSTRSET >= 7
+
+template <class V, class FLOAT>
+static inline void planarPass4T(const FLOAT *xr, const FLOAT *xi, FLOAT *yr, FLOAT *yi, int n, int s, const FLOAT *tw_re, const FLOAT *tw_im, int direction, FLOAT scale)
+{
+    const int W = 2 * FFTVecTraits<V>::COMPLEXES;
+    const int m = n / 4;
+    const V rot = V(direction > 0 ? 1 : -1);
+    const V sc = V(scale);
+    if (s % W == 0)
+    {
+        //vectorized over q, the twiddle is the same for the whole vector
+        for (int p = 0; p < m; p++)
+        {
+            const V w1_re = V(tw_re[p] * scale), w1_im = V(tw_im[p] * scale);
+            const V w2_re = V(tw_re[p + m] * scale), w2_im = V(tw_im[p + m] * scale);
+            const V w3_re = V(tw_re[p + 2 * m] * scale), w3_im = V(tw_im[p + 2 * m] * scale);
+            for (int q = 0; q < s; q += W)
+            {
+                const int i = q + s * p;
+                V a_re, a_im, b_re, b_im, c_re, c_im, d_re, d_im;
+                a_re.load(xr + i);
+                a_im.load(xi + i);
+                b_re.load(xr + i + s * m);
+                b_im.load(xi + i + s * m);
+                c_re.load(xr + i + 2 * s * m);
+                c_im.load(xi + i + 2 * s * m);
+                d_re.load(xr + i + 3 * s * m);
+                d_im.load(xi + i + 3 * s * m);
+                planarButterfly4(a_re, a_im, b_re, b_im, c_re, c_im, d_re, d_im, rot);
+                planarMul(b_re, b_im, w1_re, w1_im);
+                planarMul(c_re, c_im, w2_re, w2_im);
+                planarMul(d_re, d_im, w3_re, w3_im);
+
+                const int o = q + s * 4 * p;
+                (a_re * sc).store(yr + o);
+                (a_im * sc).store(yi + o);
+                b_re.store(yr + o + s);
+                b_im.store(yi + o + s);
+                c_re.store(yr + o + 2 * s);
+                c_im.store(yi + o + 2 * s);
+                d_re.store(yr + o + 3 * s);
+                d_im.store(yi + o + 3 * s);
+            }
+        }
+    }
+    else if (s == 1 && m % W == 0)
+    {
+        //first step: vectorized over p with the twiddles loaded as vectors,
+        //the four outputs of every p are interleaved on store
+        for (int p = 0; p < m; p += W)
+        {
+            V a_re, a_im, b_re, b_im, c_re, c_im, d_re, d_im, w_re, w_im;
+            a_re.load(xr + p);
+            a_im.load(xi + p);
+            b_re.load(xr + p + m);
+            b_im.load(xi + p + m);
+            c_re.load(xr + p + 2 * m);
+            c_im.load(xi + p + 2 * m);
+            d_re.load(xr + p + 3 * m);
+            d_im.load(xi + p + 3 * m);
+            planarButterfly4(a_re, a_im, b_re, b_im, c_re, c_im, d_re, d_im, rot);
+            w_re.load(tw_re + p);
+            w_im.load(tw_im + p);
+            planarMul(b_re, b_im, w_re, w_im);
+            w_re.load(tw_re + p + m);
+            w_im.load(tw_im + p + m);
+            planarMul(c_re, c_im, w_re, w_im);
+            w_re.load(tw_re + p + 2 * m);
+            w_im.load(tw_im + p + 2 * m);
+            planarMul(d_re, d_im, w_re, w_im);
+            if (scale != 1)
+            {
+                a_re *= sc;
+                a_im *= sc;
+                b_re *= sc;
+                b_im *= sc;
+                c_re *= sc;
+                c_im *= sc;
+                d_re *= sc;
+                d_im *= sc;
+            }
+            storeInterleaved4(a_re, b_re, c_re, d_re, yr + 4 * p);
+            storeInterleaved4(a_im, b_im, c_im, d_im, yi + 4 * p);
+        }
+    }
+    else
+    {
+        planarPass4Scalar(xr, xi, yr, yi, n, s, tw_re, tw_im, direction, scale);
+    }
+}
+
+template <class V, class FLOAT>
+static inline void planarPass2T(const FLOAT *xr, const FLOAT *xi, FLOAT *yr, FLOAT *yi, int n, int s, const FLOAT *tw_re, const FLOAT *tw_im, FLOAT scale)
+{
+    const int W = 2 * FFTVecTraits<V>::COMPLEXES;
+    const int m = n / 2;
+    const V sc = V(scale);
+    if (s % W != 0)
+    {
+        planarPass2Scalar(xr, xi, yr, yi, n, s, tw_re, tw_im, scale);
+        return;
+    }
+    for (int p = 0; p < m; p++)
+    {
+        const V w_re = V(tw_re[p] * scale), w_im = V(tw_im[p] * scale);
+        for (int q = 0; q < s; q += W)
+        {
+            const int i = q + s * p;
+            V a_re, a_im, b_re, b_im;
+            a_re.load(xr + i);
+            a_im.load(xi + i);
+            b_re.load(xr + i + s * m);
+            b_im.load(xi + i + s * m);
+            V u_re = a_re - b_re;
+            V u_im = a_im - b_im;
+            planarMul(u_re, u_im, w_re, w_im);
+            const int o = q + s * 2 * p;
+            ((a_re + b_re) * sc).store(yr + o);
+            ((a_im + b_im) * sc).store(yi + o);
+            u_re.store(yr + o + s);
+            u_im.store(yi + o + s);
+        }
+    }
+}
+
+//transform-per-lane batches, see FFTransformerLanes. W = 2 * COMPLEXES transforms
+//are processed side by side: element j of all of them is held as the vector of
+//their W real parts followed by the vector of their W imaginary parts at
+//buf + 2 * W * j. On that layout a Stockham step is vertical arithmetic on whole
+//vectors with broadcast twiddles, the only permutes are the transposes on load and store
+
+//W x W transpose: row l of W FLOATs at src + l * src_step goes to column l of the
+//rows at dst + i * dst_step. Written out per vector type so that the rows stay in registers
+template <class V>
+static inline void transposeLanes(const typename FFTVecTraits<V>::FLOAT *src, size_t src_step,
+                                  typename FFTVecTraits<V>::FLOAT *dst, size_t dst_step);
+
+template <>
+inline void transposeLanes<Vec4f>(const float *src, size_t src_step, float *dst, size_t dst_step)
+{
+    Vec4f r0, r1, r2, r3;
+    r0.load(src);
+    r1.load(src + src_step);
+    r2.load(src + 2 * src_step);
+    r3.load(src + 3 * src_step);
+    Vec4f t0 = blend4f<0,4,1,5>(r0, r1);
+    Vec4f t1 = blend4f<2,6,3,7>(r0, r1);
+    Vec4f t2 = blend4f<0,4,1,5>(r2, r3);
+    Vec4f t3 = blend4f<2,6,3,7>(r2, r3);
+    blend4f<0,1,4,5>(t0, t2).store(dst);
+    blend4f<2,3,6,7>(t0, t2).store(dst + dst_step);
+    blend4f<0,1,4,5>(t1, t3).store(dst + 2 * dst_step);
+    blend4f<2,3,6,7>(t1, t3).store(dst + 3 * dst_step);
+}
+
+template <>
+inline void transposeLanes<Vec4d>(const double *src, size_t src_step, double *dst, size_t dst_step)
+{
+    Vec4d r0, r1, r2, r3;
+    r0.load(src);
+    r1.load(src + src_step);
+    r2.load(src + 2 * src_step);
+    r3.load(src + 3 * src_step);
+    Vec4d t0 = blend4d<0,4,2,6>(r0, r1);
+    Vec4d t1 = blend4d<1,5,3,7>(r0, r1);
+    Vec4d t2 = blend4d<0,4,2,6>(r2, r3);
+    Vec4d t3 = blend4d<1,5,3,7>(r2, r3);
+    blend4d<0,1,4,5>(t0, t2).store(dst);
+    blend4d<0,1,4,5>(t1, t3).store(dst + dst_step);
+    blend4d<2,3,6,7>(t0, t2).store(dst + 2 * dst_step);
+    blend4d<2,3,6,7>(t1, t3).store(dst + 3 * dst_step);
+}
+
+#if INSTRSET >= 7
+//4 x 4 transposes within the 128-bit lanes, then the lane halves are exchanged.
+//Written with the unpack and shuffle intrinsics, blend8f turns these patterns into permutes
+template <>
+inline void transposeLanes<Vec8f>(const float *src, size_t src_step, float *dst, size_t dst_step)
+{
+    __m256 r0 = _mm256_loadu_ps(src);
+    __m256 r1 = _mm256_loadu_ps(src + src_step);
+    __m256 r2 = _mm256_loadu_ps(src + 2 * src_step);
+    __m256 r3 = _mm256_loadu_ps(src + 3 * src_step);
+    __m256 r4 = _mm256_loadu_ps(src + 4 * src_step);
+    __m256 r5 = _mm256_loadu_ps(src + 5 * src_step);
+    __m256 r6 = _mm256_loadu_ps(src + 6 * src_step);
+    __m256 r7 = _mm256_loadu_ps(src + 7 * src_step);
+    __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+    __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+    __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+    __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+    __m256 t4 = _mm256_unpacklo_ps(r4, r5);
+    __m256 t5 = _mm256_unpackhi_ps(r4, r5);
+    __m256 t6 = _mm256_unpacklo_ps(r6, r7);
+    __m256 t7 = _mm256_unpackhi_ps(r6, r7);
+    __m256 u0 = _mm256_shuffle_ps(t0, t2, 0x44);
+    __m256 u1 = _mm256_shuffle_ps(t0, t2, 0xEE);
+    __m256 u2 = _mm256_shuffle_ps(t1, t3, 0x44);
+    __m256 u3 = _mm256_shuffle_ps(t1, t3, 0xEE);
+    __m256 u4 = _mm256_shuffle_ps(t4, t6, 0x44);
+    __m256 u5 = _mm256_shuffle_ps(t4, t6, 0xEE);
+    __m256 u6 = _mm256_shuffle_ps(t5, t7, 0x44);
+    __m256 u7 = _mm256_shuffle_ps(t5, t7, 0xEE);
+    _mm256_storeu_ps(dst,                _mm256_permute2f128_ps(u0, u4, 0x20));
+    _mm256_storeu_ps(dst + dst_step,     _mm256_permute2f128_ps(u1, u5, 0x20));
+    _mm256_storeu_ps(dst + 2 * dst_step, _mm256_permute2f128_ps(u2, u6, 0x20));
+    _mm256_storeu_ps(dst + 3 * dst_step, _mm256_permute2f128_ps(u3, u7, 0x20));
+    _mm256_storeu_ps(dst + 4 * dst_step, _mm256_permute2f128_ps(u0, u4, 0x31));
+    _mm256_storeu_ps(dst + 5 * dst_step, _mm256_permute2f128_ps(u1, u5, 0x31));
+    _mm256_storeu_ps(dst + 6 * dst_step, _mm256_permute2f128_ps(u2, u6, 0x31));
+    _mm256_storeu_ps(dst + 7 * dst_step, _mm256_permute2f128_ps(u3, u7, 0x31));
+}
+#endif // INSTRSET >= 7
+
+//W adjacent complex points at src split into the vector of their real parts at dst
+//and that of their imaginary parts at dst + W. The lanes may come out permuted, mergeLanes
+//puts them back, the transforms in between do not mix lanes
+template <class V>
+static inline void splitLanes(const typename FFTVecTraits<V>::FLOAT *src, typename FFTVecTraits<V>::FLOAT *dst);
+template <class V>
+static inline void mergeLanes(const typename FFTVecTraits<V>::FLOAT *src, typename FFTVecTraits<V>::FLOAT *dst);
+
+template <>
+inline void splitLanes<Vec4f>(const float *src, float *dst)
+{
+    Vec4f a, b;
+    a.load(src);
+    b.load(src + 4);
+    blend4f<0,2,4,6>(a, b).store(dst);
+    blend4f<1,3,5,7>(a, b).store(dst + 4);
+}
+
+template <>
+inline void mergeLanes<Vec4f>(const float *src, float *dst)
+{
+    Vec4f re, im;
+    re.load(src);
+    im.load(src + 4);
+    blend4f<0,4,1,5>(re, im).store(dst);
+    blend4f<2,6,3,7>(re, im).store(dst + 4);
+}
+
+//lanes in the order 0 2 1 3
+template <>
+inline void splitLanes<Vec4d>(const double *src, double *dst)
+{
+    Vec4d a, b;
+    a.load(src);
+    b.load(src + 4);
+    blend4d<0,4,2,6>(a, b).store(dst);
+    blend4d<1,5,3,7>(a, b).store(dst + 4);
+}
+
+template <>
+inline void mergeLanes<Vec4d>(const double *src, double *dst)
+{
+    Vec4d re, im;
+    re.load(src);
+    im.load(src + 4);
+    blend4d<0,4,2,6>(re, im).store(dst);
+    blend4d<1,5,3,7>(re, im).store(dst + 4);
+}
+
+#if INSTRSET >= 7
+//lanes in the order 0 1 4 5 2 3 6 7
+template <>
+inline void splitLanes<Vec8f>(const float *src, float *dst)
+{
+    __m256 a = _mm256_loadu_ps(src);
+    __m256 b = _mm256_loadu_ps(src + 8);
+    _mm256_storeu_ps(dst,     _mm256_shuffle_ps(a, b, 0x88));
+    _mm256_storeu_ps(dst + 8, _mm256_shuffle_ps(a, b, 0xDD));
+}
+
+template <>
+inline void mergeLanes<Vec8f>(const float *src, float *dst)
+{
+    __m256 re = _mm256_loadu_ps(src);
+    __m256 im = _mm256_loadu_ps(src + 8);
+    _mm256_storeu_ps(dst,     _mm256_unpacklo_ps(re, im));
+    _mm256_storeu_ps(dst + 8, _mm256_unpackhi_ps(re, im));
+}
+#endif // INSTRSET >= 7
+
+//count <= W transforms at in + l * dist into the lane layout, missing lanes are zero.
+//Full groups of contiguous transforms go through the vector transpose. Full groups
+//of adjacent ones (dist 1, e.g. the columns of a matrix) only need the real and
+//imaginary parts split. Other strides and the last partial group go element by element
+template <class V, class FLOAT>
+static inline void lanesLoad(const Complex<FLOAT> *in, int length, int count, int stride, int dist, FLOAT *buf)
+{
+    const int C = FFTVecTraits<V>::COMPLEXES;
+    const int W = 2 * C;
+    if (count == W && stride == 1 && length % C == 0)
+    {
+        const FLOAT *x = (const FLOAT*)in;
+        for (int j = 0; j < length; j += C)
+        {
+            transposeLanes<V>(x + 2 * j, 2 * (size_t)dist, buf + 2 * W * j, W);
+        }
+        return;
+    }
+    if (count == W && dist == 1)
+    {
+        for (int j = 0; j < length; j++)
+        {
+            splitLanes<V>((const FLOAT*)(in + (size_t)j * stride), buf + 2 * W * j);
+        }
+        return;
+    }
+    for (int j = 0; j < length; j++)
+    {
+        FLOAT *b = buf + 2 * W * j;
+        for (int l = 0; l < W; l++)
+        {
+            if (l < count)
+            {
+                const Complex<FLOAT> x = in[(size_t)l * dist + (size_t)j * stride];
+                b[l] = x.re;
+                b[W + l] = x.im;
+            }
+            else
+            {
+                b[l] = 0;
+                b[W + l] = 0;
+            }
+        }
+    }
+}
+
+template <class V, class FLOAT>
+static inline void lanesStore(const FLOAT *buf, Complex<FLOAT> *out, int length, int count, int stride, int dist)
+{
+    const int C = FFTVecTraits<V>::COMPLEXES;
+    const int W = 2 * C;
+    if (count == W && stride == 1 && length % C == 0)
+    {
+        FLOAT *y = (FLOAT*)out;
+        for (int j = 0; j < length; j += C)
+        {
+            transposeLanes<V>(buf + 2 * W * j, W, y + 2 * j, 2 * (size_t)dist);
+        }
+        return;
+    }
+    if (count == W && dist == 1)
+    {
+        for (int j = 0; j < length; j++)
+        {
+            mergeLanes<V>(buf + 2 * W * j, (FLOAT*)(out + (size_t)j * stride));
+        }
+        return;
+    }
+    for (int j = 0; j < length; j++)
+    {
+        const FLOAT *b = buf + 2 * W * j;
+        for (int l = 0; l < count; l++)
+        {
+            Complex<FLOAT> &y = out[(size_t)l * dist + (size_t)j * stride];
+            y.re = b[l];
+            y.im = b[W + l];
+        }
+    }
+}
+
+//Stockham radix-4 step on lane complexes, twiddles[(k - 1) * m + p] = W_n^(k p)
+template <class V, class FLOAT>
+static inline void lanesPass4(const FLOAT *x, FLOAT *y, int n, int s, const Complex<FLOAT> *twiddles, int direction, FLOAT scale)
+{
+    const int W = 2 * FFTVecTraits<V>::COMPLEXES;
+    const int m = n / 4;
+    const V rot = V((FLOAT)(direction > 0 ? 1 : -1));
+    const V sc = V(scale);
+    //distance of the butterfly legs on input and output
+    const int in_step = 2 * W * s * m;
+    const int out_step = 2 * W * s;
+    for (int p = 0; p < m; p++)
+    {
+        const V w1_re = V(twiddles[p].re * scale), w1_im = V(twiddles[p].im * scale);
+        const V w2_re = V(twiddles[p + m].re * scale), w2_im = V(twiddles[p + m].im * scale);
+        const V w3_re = V(twiddles[p + 2 * m].re * scale), w3_im = V(twiddles[p + 2 * m].im * scale);
+        for (int q = 0; q < s; q++)
+        {
+            const FLOAT *a = x + 2 * W * (q + s * p);
+            V a_re, a_im, b_re, b_im, c_re, c_im, d_re, d_im;
+            a_re.load(a);
+            a_im.load(a + W);
+            b_re.load(a + in_step);
+            b_im.load(a + in_step + W);
+            c_re.load(a + 2 * in_step);
+            c_im.load(a + 2 * in_step + W);
+            d_re.load(a + 3 * in_step);
+            d_im.load(a + 3 * in_step + W);
+            planarButterfly4(a_re, a_im, b_re, b_im, c_re, c_im, d_re, d_im, rot);
+            planarMul(b_re, b_im, w1_re, w1_im);
+            planarMul(c_re, c_im, w2_re, w2_im);
+            planarMul(d_re, d_im, w3_re, w3_im);
+
+            FLOAT *o = y + 2 * W * (q + s * 4 * p);
+            (a_re * sc).store(o);
+            (a_im * sc).store(o + W);
+            b_re.store(o + out_step);
+            b_im.store(o + out_step + W);
+            c_re.store(o + 2 * out_step);
+            c_im.store(o + 2 * out_step + W);
+            d_re.store(o + 3 * out_step);
+            d_im.store(o + 3 * out_step + W);
+        }
+    }
+}
+
+template <class V, class FLOAT>
+static inline void lanesPass2(const FLOAT *x, FLOAT *y, int n, int s, const Complex<FLOAT> *twiddles, FLOAT scale)
+{
+    const int W = 2 * FFTVecTraits<V>::COMPLEXES;
+    const int m = n / 2;
+    const V sc = V(scale);
+    const int in_step = 2 * W * s * m;
+    const int out_step = 2 * W * s;
+    for (int p = 0; p < m; p++)
+    {
+        const V w_re = V(twiddles[p].re * scale), w_im = V(twiddles[p].im * scale);
+        for (int q = 0; q < s; q++)
+        {
+            const FLOAT *a = x + 2 * W * (q + s * p);
+            V a_re, a_im, b_re, b_im;
+            a_re.load(a);
+            a_im.load(a + W);
+            b_re.load(a + in_step);
+            b_im.load(a + in_step + W);
+            V u_re = a_re - b_re;
+            V u_im = a_im - b_im;
+            planarMul(u_re, u_im, w_re, w_im);
+            FLOAT *o = y + 2 * W * (q + s * 2 * p);
+            ((a_re + b_re) * sc).store(o);
+            ((a_im + b_im) * sc).store(o + W);
+            u_re.store(o + out_step);
+            u_im.store(o + out_step + W);
+        }
+    }
+}
+
+//howmany transforms in groups of W, the last group is padded with zero lanes.
+//work holds the two lane buffers of 2 * W * length FLOATs, 32 byte aligned. The
+//second one is pushed off by 4 lane complexes, at a multiple of 4K apart the loads
+//of a step would alias the stores of the step before in the L1
+template <class V, class FLOAT>
+static inline void lanesBatchT(const Complex<FLOAT> *in, Complex<FLOAT> *out, int length, int howmany, int stride, int dist,
+                               const Complex<FLOAT> *twiddles, FLOAT *work, int direction, FLOAT scale)
+{
+    const int W = 2 * FFTVecTraits<V>::COMPLEXES;
+    FLOAT *buf0 = work;
+    FLOAT *buf1 = work + 2 * W * (length + 4);
+    for (int first = 0; first < howmany; first += W)
+    {
+        const int count = (howmany - first < W) ? howmany - first : W;
+        lanesLoad<V>(in + (size_t)first * dist, length, count, stride, dist, buf0);
+        FLOAT *src = buf0;
+        FLOAT *dst = buf1;
+        const Complex<FLOAT> *tw = twiddles;
+        int n = length;
+        int s = 1;
+        for (; n >= 4; n /= 4, s *= 4)
+        {
+            //the last step applies the normalization
+            lanesPass4<V>(src, dst, n, s, tw, direction, (n == 4) ? scale : (FLOAT)1);
+            tw += 3 * (n / 4);
+            FLOAT *t = src;
+            src = dst;
+            dst = t;
+        }
+        if (n == 2)
+        {
+            lanesPass2<V>(src, dst, n, s, tw, scale);
+            src = dst;
+        }
+        lanesStore<V>(src, out + (size_t)first * dist, length, count, stride, dist);
+    }
+}
+
+//real transform post pass: z holds the half length transform Z of
+//z[n] = x[2n] + i x[2n + 1], half = N / 2. With E = (Z[k] + conj(Z[half - k])) / 2,
+//O = (Z[k] - conj(Z[half - k])) / 2 and F = -i W^k O the spectrum of x is
+//X[k] = E + F and X[half - k] = conj(E - F), twiddles[k] = W_N^k.
+//Bins 0 and half are set by the caller, this pass handles 1 <= k <= half / 2.
+//The plan normalization is folded into the factor 1/2
+template <class FLOAT>
+static inline void realPostPassScalar(Complex<FLOAT> *z, int half, const Complex<FLOAT> *twiddles, int k_begin, FLOAT scale)
+{
+    const FLOAT h = (FLOAT)0.5 * scale;
+    for (int k = k_begin; 2 * k <= half; k++)
+    {
+        const Complex<FLOAT> a = z[k];
+        const Complex<FLOAT> b = z[half - k];
+        const Complex<FLOAT> w = twiddles[k];
+        FLOAT e_re = (a.re + b.re) * h, e_im = (a.im - b.im) * h;
+        FLOAT o_re = (a.re - b.re) * h, o_im = (a.im + b.im) * h;
+        //F = -i * W * O
+        FLOAT f_re =  (o_re * w.im + o_im * w.re);
+        FLOAT f_im = -(o_re * w.re - o_im * w.im);
+        z[k].re = e_re + f_re;
+        z[k].im = e_im + f_im;
+        z[half - k].re =   e_re - f_re;
+        z[half - k].im = -(e_im - f_im);
+    }
+}
+
+//real inverse pre pass, the counterpart of realPostPass on the bins X[0..half]:
+//with E = X[k] + conj(X[half - k]) and G = i conj(W^k) (X[k] - conj(X[half - k]))
+//the half length input is Z[k] = E + G, Z[half - k] = conj(E - G). Its inverse
+//transform is x[2n] + i x[2n + 1] scaled by N like the complex inverse.
+//Bin 0 is set by the caller, this pass handles 1 <= k <= half / 2.
+//The plan normalization scales E and the twiddle. The bins are read from x and
+//Z is written to z, x == z runs in place
+template <class FLOAT>
+static inline void realPrePassScalar(const Complex<FLOAT> *x, Complex<FLOAT> *z, int half, const Complex<FLOAT> *twiddles, int k_begin, FLOAT scale)
+{
+    for (int k = k_begin; 2 * k <= half; k++)
+    {
+        const Complex<FLOAT> a = x[k];
+        const Complex<FLOAT> b = x[half - k];
+        const Complex<FLOAT> w = scaleTwiddle(twiddles[k], scale);
+        FLOAT e_re = (a.re + b.re) * scale, e_im = (a.im - b.im) * scale;
+        FLOAT d_re = a.re - b.re, d_im = a.im + b.im;
+        //G = i * conj(W) * D
+        FLOAT g_re = -(d_im * w.re - d_re * w.im);
+        FLOAT g_im =   d_re * w.re + d_im * w.im;
+        z[k].re = e_re + g_re;
+        z[k].im = e_im + g_im;
+        z[half - k].re =   e_re - g_re;
+        z[half - k].im = -(e_im - g_im);
+    }
+}
+
+template <class V, class FLOAT>
+static inline void realPrePassT(const Complex<FLOAT> *x, Complex<FLOAT> *z, int half, const Complex<FLOAT> *twiddles, FLOAT scale)
+{
+    const int C = FFTVecTraits<V>::COMPLEXES;
+    const V sc = laneConst<V>(scale, scale, scale, scale);
+    int k = 1;
+    for (; 2 * (k + C) - 1 <= half; k += C)
+    {
+        Complex<FLOAT> *pa = &z[k];
+        Complex<FLOAT> *pb = &z[half - k - C + 1];
+        V a, b, w, tw_norm, tw_perm;
+        a.load((const FLOAT*)&x[k]);
+        b.load((const FLOAT*)&x[half - k - C + 1]);
+        w.load((const FLOAT*)&twiddles[k]);
+        b = laneChangeSign<0,1,0,1>(reverseComplexes(b));
+        splitTwiddle(tw_norm, tw_perm, laneChangeSign<0,1,0,1>(w) * sc);
+
+        V e = (a + b) * sc;
+        V g = complexMul(a - b, tw_norm, tw_perm);
+        g = laneChangeSign<1,0,1,0>(lanePermute<1,0,3,2>(g));
+
+        V za = e + g;
+        V zb = laneChangeSign<0,1,0,1>(e - g);
+        za.store((FLOAT*)pa);
+        reverseComplexes(zb).store((FLOAT*)pb);
+    }
+    realPrePassScalar(x, z, half, twiddles, k, scale);
+}
+
+//vectorized over k, the mirrored block is loaded and stored in reverse order.
+//Blocks start at k = 1, so all accesses are unaligned
+template <class V, class FLOAT>
+static inline void realPostPassT(Complex<FLOAT> *z, int half, const Complex<FLOAT> *twiddles, FLOAT scale)
+{
+    const int C = FFTVecTraits<V>::COMPLEXES;
+    const FLOAT h = (FLOAT)0.5 * scale;
+    const V one_half = laneConst<V>(h, h, h, h);
+    int k = 1;
+    for (; 2 * (k + C) - 1 <= half; k += C)
+    {
+        Complex<FLOAT> *pa = &z[k];
+        Complex<FLOAT> *pb = &z[half - k - C + 1];
+        V a, b, w, tw_norm, tw_perm;
+        a.load((const FLOAT*)pa);
+        b.load((const FLOAT*)pb);
+        w.load((const FLOAT*)&twiddles[k]);
+        b = laneChangeSign<0,1,0,1>(reverseComplexes(b));
+        splitTwiddle(tw_norm, tw_perm, w);
+
+        V e = (a + b) * one_half;
+        V o = (a - b) * one_half;
+        V f = complexMul(o, tw_norm, tw_perm);
+        f = laneChangeSign<0,1,0,1>(lanePermute<1,0,3,2>(f));
+
+        V xa = e + f;
+        V xb = laneChangeSign<0,1,0,1>(e - f);
+        xa.store((FLOAT*)pa);
+        reverseComplexes(xb).store((FLOAT*)pb);
+    }
+    realPostPassScalar(z, half, twiddles, k, scale);
+}
+
+//widest available vector for the build's instruction set
+static inline void fftFirstPass(Complex<float> *data, int length, int direction, float scale)
+{
+    if (length < 8)
+    {
+        fftFirstPassSmall(data, length, direction, scale);
+        return;
+    }
+#if INSTRSET >= 7
+    if (length >= 16)
+    {
+        fftFirstPassT<Vec8f>(data, length, direction, scale);
+        return;
+    }
+#endif
+    fftFirstPassT<Vec4f>(data, length, direction, scale);
+}
+
+//out of place first pass, reading data[i] from src[perm[i] * stride]
+static inline void fftFirstPassGather(const Complex<float> *src, Complex<float> *data, int length, const uint *perm, int stride, int direction, float scale)
+{
+    if (length < 8)
+    {
+        for (int i = 0; i < length; i++)
+        {
+            data[i] = src[(size_t)perm[i] * stride];
+        }
+        fftFirstPassSmall(data, length, direction, scale);
+        return;
+    }
+#if INSTRSET >= 7
+    if (length >= 16)
+    {
+        fftFirstPassT<Vec8f>(data, length, direction, scale, src, perm, stride);
+        return;
+    }
+#endif
+    fftFirstPassT<Vec4f>(data, length, direction, scale, src, perm, stride);
+}
+
+#if INSTRSET >= 7
+typedef Vec8f FFTVecFloat;
+#else
+typedef Vec4f FFTVecFloat;
+#endif
+
+static inline void fftTwiddlePass(Complex<float> *data, int length, int twiddle_number, const Complex<float> *twiddles)
+{
+    fftTwiddlePassT<FFTVecFloat>(data, length, twiddle_number, twiddles);
+}
+
+static inline void fftTwiddlePassRange(Complex<float> *data, int length, int twiddle_number, const Complex<float> *twiddles, int tw_begin, int tw_end)
+{
+    fftTwiddlePassT<FFTVecFloat>(data, length, twiddle_number, twiddles, tw_begin, tw_end);
+}
+
+static inline void fftTwiddlePass4(Complex<float> *data, int length, int twiddle_number, const Complex<float> *twiddles)
+{
+    fftTwiddlePass4T<FFTVecFloat>(data, length, twiddle_number, twiddles);
+}
+
+static inline void fftTwiddlePass8(Complex<float> *data, int length, int twiddle_number, const Complex<float> *twiddles)
+{
+    fftTwiddlePass8T<FFTVecFloat>(data, length, twiddle_number, twiddles);
+}
+
+static inline void fftStockhamPass4(const Complex<float> *x, Complex<float> *y, int n, int s, const Complex<float> *twiddles, int direction, float scale)
+{
+    stockhamPass4T<FFTVecFloat>(x, y, n, s, twiddles, direction, scale);
+}
+
+static inline void fftStockhamPass2(const Complex<float> *x, Complex<float> *y, int n, int s, const Complex<float> *twiddles, float scale)
+{
+    stockhamPass2T<FFTVecFloat>(x, y, n, s, twiddles, scale);
+}
+
+//the widest vector the stride allows, a radix-2 step leaves s = 2 for example
+static inline void fftStockhamPassOdd(const Complex<float> *x, Complex<float> *y, int n, int s, int radix, const Complex<float> *twiddles, int direction, float scale)
+{
+#if INSTRSET >= 7
+    if (s % 4 == 0)
+    {
+        stockhamPassOddRadix<Vec8f>(x, y, n, s, radix, twiddles, direction, scale);
+        return;
+    }
+#endif
+    if (s % 2 == 0)
+        stockhamPassOddRadix<Vec4f>(x, y, n, s, radix, twiddles, direction, scale);
+    else
+        stockhamPassOddScalar(x, y, n, s, radix, twiddles, direction, scale);
+}
+
+//planar steps: a stride narrower than Vec8f takes Vec4f, which falls back to scalar below 4
+static inline void fftPlanarPass4(const float *xr, const float *xi, float *yr, float *yi, int n, int s, const float *tw_re, const float *tw_im, int direction, float scale)
+{
+#if INSTRSET >= 7
+    if (s % 8 == 0 || (s == 1 && (n / 4) % 8 == 0))
+    {
+        planarPass4T<Vec8f>(xr, xi, yr, yi, n, s, tw_re, tw_im, direction, scale);
+        return;
+    }
+#endif
+    planarPass4T<Vec4f>(xr, xi, yr, yi, n, s, tw_re, tw_im, direction, scale);
+}
+
+static inline void fftPlanarPass2(const float *xr, const float *xi, float *yr, float *yi, int n, int s, const float *tw_re, const float *tw_im, float scale)
+{
+#if INSTRSET >= 7
+    if (s % 8 == 0)
+    {
+        planarPass2T<Vec8f>(xr, xi, yr, yi, n, s, tw_re, tw_im, scale);
+        return;
+    }
+#endif
+    planarPass2T<Vec4f>(xr, xi, yr, yi, n, s, tw_re, tw_im, scale);
+}
+
+//Vec8f puts 8 transforms side by side, Vec4f 4
+static inline void fftLanesBatch(const Complex<float> *in, Complex<float> *out, int length, int howmany, int stride, int dist,
+                                 const Complex<float> *twiddles, float *work, int direction, float scale)
+{
+    lanesBatchT<FFTVecFloat>(in, out, length, howmany, stride, dist, twiddles, work, direction, scale);
+}
+
+static inline void fftRealPostPass(Complex<float> *z, int half, const Complex<float> *twiddles, float scale)
+{
+    realPostPassT<FFTVecFloat>(z, half, twiddles, scale);
+}
+
+static inline void fftRealPrePass(const Complex<float> *x, Complex<float> *z, int half, const Complex<float> *twiddles, float scale)
+{
+    realPrePassT<FFTVecFloat>(x, z, half, twiddles, scale);
+}
+
+//double precision: Vec4d on every instruction set
+static inline void fftFirstPass(Complex<double> *data, int length, int direction, double scale)
+{
+    if (length < 8)
+    {
+        fftFirstPassSmall(data, length, direction, scale);
+        return;
+    }
+    fftFirstPassT<Vec4d>(data, length, direction, scale);
+}
+
+static inline void fftFirstPassGather(const Complex<double> *src, Complex<double> *data, int length, const uint *perm, int stride, int direction, double scale)
+{
+    if (length < 8)
+    {
+        for (int i = 0; i < length; i++)
+        {
+            data[i] = src[(size_t)perm[i] * stride];
+        }
+        fftFirstPassSmall(data, length, direction, scale);
+        return;
+    }
+    fftFirstPassT<Vec4d>(data, length, direction, scale, src, perm, stride);
+}
+
+static inline void fftTwiddlePass(Complex<double> *data, int length, int twiddle_number, const Complex<double> *twiddles)
+{
+    fftTwiddlePassT<Vec4d>(data, length, twiddle_number, twiddles);
+}
+
+static inline void fftTwiddlePassRange(Complex<double> *data, int length, int twiddle_number, const Complex<double> *twiddles, int tw_begin, int tw_end)
+{
+    fftTwiddlePassT<Vec4d>(data, length, twiddle_number, twiddles, tw_begin, tw_end);
+}
+
+static inline void fftTwiddlePass4(Complex<double> *data, int length, int twiddle_number, const Complex<double> *twiddles)
+{
+    fftTwiddlePass4T<Vec4d>(data, length, twiddle_number, twiddles);
+}
+
+static inline void fftTwiddlePass8(Complex<double> *data, int length, int twiddle_number, const Complex<double> *twiddles)
+{
+    fftTwiddlePass8T<Vec4d>(data, length, twiddle_number, twiddles);
+}
+
+static inline void fftStockhamPass4(const Complex<double> *x, Complex<double> *y, int n, int s, const Complex<double> *twiddles, int direction, double scale)
+{
+    stockhamPass4T<Vec4d>(x, y, n, s, twiddles, direction, scale);
+}
+
+static inline void fftStockhamPass2(const Complex<double> *x, Complex<double> *y, int n, int s, const Complex<double> *twiddles, double scale)
+{
+    stockhamPass2T<Vec4d>(x, y, n, s, twiddles, scale);
+}
+
+static inline void fftRealPostPass(Complex<double> *z, int half, const Complex<double> *twiddles, double scale)
+{
+    realPostPassT<Vec4d>(z, half, twiddles, scale);
+}
+
+static inline void fftRealPrePass(const Complex<double> *x, Complex<double> *z, int half, const Complex<double> *twiddles, double scale)
+{
+    realPrePassT<Vec4d>(x, z, half, twiddles, scale);
+}
+
+static inline void fftPlanarPass4(const double *xr, const double *xi, double *yr, double *yi, int n, int s, const double *tw_re, const double *tw_im, int direction, double scale)
+{
+    planarPass4T<Vec4d>(xr, xi, yr, yi, n, s, tw_re, tw_im, direction, scale);
+}
+
+static inline void fftPlanarPass2(const double *xr, const double *xi, double *yr, double *yi, int n, int s, const double *tw_re, const double *tw_im, double scale)
+{
+    planarPass2T<Vec4d>(xr, xi, yr, yi, n, s, tw_re, tw_im, scale);
+}
+
+static inline void fftLanesBatch(const Complex<double> *in, Complex<double> *out, int length, int howmany, int stride, int dist,
+                                 const Complex<double> *twiddles, double *work, int direction, double scale)
+{
+    lanesBatchT<Vec4d>(in, out, length, howmany, stride, dist, twiddles, work, direction, scale);
+}
+
+static inline void fftStockhamPassOdd(const Complex<double> *x, Complex<double> *y, int n, int s, int radix, const Complex<double> *twiddles, int direction, double scale)
+{
+    if (s % 2 == 0)
+        stockhamPassOddRadix<Vec4d>(x, y, n, s, radix, twiddles, direction, scale);
+    else
+        stockhamPassOddScalar(x, y, n, s, radix, twiddles, direction, scale);
+}
+
+//kernel table of the instruction set this unit is compiled for
+#if defined(__FMA__) && INSTRSET >= 8
+#define FFT_KERNEL_LEVEL FFT_INSTRSET_FMA3
+#else
+#define FFT_KERNEL_LEVEL INSTRSET
+#endif
+
+//the float and double tables share the initializer, overloads are resolved by the pointer types
+//tables at global scope, ns is the namespace the unit included this header in
+#define FFT_KERNEL_TABLE_INIT(ns) \
+    { FFT_KERNEL_LEVEL, &ns::fftFirstPass, &ns::fftFirstPassGather, &ns::fftTwiddlePass, &ns::fftTwiddlePassRange, \
+      &ns::fftTwiddlePass4, &ns::fftTwiddlePass8, \
+      &ns::fftStockhamPass4, &ns::fftStockhamPass2, &ns::fftStockhamPassOdd, \
+      &ns::fftRealPostPass, &ns::fftRealPrePass, \
+      &ns::fftPlanarPass4, &ns::fftPlanarPass2, &ns::fftLanesBatch }
+
+#define FFT_KERNEL_TABLE(isa, ns) \
+    FFTKernelTable<float>  FFTKernels_##isa       = FFT_KERNEL_TABLE_INIT(ns); \
+    FFTKernelTable<double> FFTKernelsDouble_##isa = FFT_KERNEL_TABLE_INIT(ns)
+
+#endif // FFTVECKERNELS_H
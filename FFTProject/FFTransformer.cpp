@@ -29,6 +29,12 @@ uint FFTransformer<FLOAT>::bitReverseInt32(uint v)
 template <class FLOAT>
 void FFTransformer<FLOAT>::arrayShuffle(Complex<FLOAT>* data, int length)
 {
+    //blocked permutation once the table walk starts missing the caches
+    if (length >= FFTBitReverse<FLOAT>::MIN_LENGTH)
+    {
+        bitReverse.Shuffle(data);
+        return;
+    }
 	for (int i = 0; i < length; i++)
 	{
 		int rev_ind = shuffle_ind[i];
@@ -41,6 +47,21 @@ void FFTransformer<FLOAT>::arrayShuffle(Complex<FLOAT>* data, int length)
 	}
 }
 
+//bit reversed copy, the permutation of an out of place transform
+template <class FLOAT>
+void FFTransformer<FLOAT>::arrayShuffle(const Complex<FLOAT>* in, Complex<FLOAT>* out, int length)
+{
+    if (length >= FFTBitReverse<FLOAT>::MIN_LENGTH)
+    {
+        bitReverse.Shuffle(in, out);
+        return;
+    }
+    for (int i = 0; i < length; i++)
+    {
+        out[i] = in[shuffle_ind[i]];
+    }
+}
+
 template <class FLOAT>
 FFTransformer<FLOAT>::FFTransformer() : twiddles(0), shuffle_ind(0)
 {
@@ -48,9 +69,9 @@ FFTransformer<FLOAT>::FFTransformer() : twiddles(0), shuffle_ind(0)
 }
 
 template <class FLOAT>
-FFTransformer<FLOAT>::FFTransformer(int fftLength, int direction) : twiddles(0)
+FFTransformer<FLOAT>::FFTransformer(int fftLength, int direction, FFTNormalization normalization) : twiddles(0)
 {
-    FFTInit(fftLength, direction);
+    FFTInit(fftLength, direction, normalization);
 }
 
 template <class FLOAT>
@@ -67,19 +88,22 @@ FFTransformer<FLOAT>::~FFTransformer()
 }
 
 template <class FLOAT>
-bool FFTransformer<FLOAT>::FFTInit(int fftLength, int direction)
+bool FFTransformer<FLOAT>::FFTInit(int fftLength, int direction, FFTNormalization normalization)
 {
     if (fftLength > 0 && isPowerOfTwo(fftLength))
     {
         this->length = fftLength;
         this->direction = direction > 0 ? 1 : 0;
+        //the twiddles take the sign of the direction, any positive value is forward
+        int sign = direction > 0 ? 1 : -1;
+        this->scale = FFTNormalizationScale(normalization, fftLength);
         this->twiddles    = new Complex<FLOAT>[fftLength];
         this->shuffle_ind = new uint[fftLength];
         for (int twSteep = 1; twSteep < fftLength; twSteep *= 2)
         {
             for (int i = 0; i < twSteep; i++)
             {
-                FLOAT twAngle = -M_PI * direction * i / twSteep;
+                FLOAT twAngle = -M_PI * sign * i / twSteep;
                 twiddles[twSteep + i - 1].re = cos(twAngle);
                 twiddles[twSteep + i - 1].im = sin(twAngle);
             }
@@ -89,6 +113,7 @@ bool FFTransformer<FLOAT>::FFTInit(int fftLength, int direction)
         {
             shuffle_ind[i] = bitReverseInt32(i) >> bit_cnt;
         }
+        bitReverse.Init(length);
         return true;
     }
     else
@@ -97,12 +122,35 @@ bool FFTransformer<FLOAT>::FFTInit(int fftLength, int direction)
 
 template <class FLOAT>
 bool FFTransformer<FLOAT>::FFTransform(Complex<FLOAT>* data)
+{
+    return FFTransform(data, data);
+}
+
+template <class FLOAT>
+bool FFTransformer<FLOAT>::FFTransform(const Complex<FLOAT>* in, Complex<FLOAT>* data)
 {
     if (length <= 0 || !isPowerOfTwo(length)) return false;
+    if (in == data)
+        arrayShuffle(data, length);
+    else
+        arrayShuffle(in, data, length);
     if (length == 1) return true;
-	arrayShuffle(data, length);
 	int stages = getPowerOfTwo(length);
-	//explicit first steep with singular twiddles
+	if (length == 2)
+    {
+        Complex<FLOAT> &a = data[0];
+        Complex<FLOAT> &b = data[1];
+        FLOAT ur = a.re - b.re;
+        FLOAT ui = a.im - b.im;
+        a.re = (a.re + b.re) * scale;
+        a.im = (a.im + b.im) * scale;
+        b.re = ur * scale;
+        b.im = ui * scale;
+        return true;
+    }
+	//explicit first steep with singular twiddles, the normalization is folded in.
+	//rot is the sign of the quarter turn, -i for the forward transform
+	FLOAT rot = direction ? 1 : -1;
 	int steep = 4;
 	for (int butterfly = 0; butterfly < length; butterfly += steep)
     {
@@ -121,17 +169,16 @@ bool FFTransformer<FLOAT>::FFTransform(Complex<FLOAT>* data)
         FLOAT ud = c.re - d.re;
         FLOAT vd = c.im - d.im;
 
-        a.re = ua + uc;
-        a.im = va + vc;
-        c.re = ua - uc;
-        c.im = va - vc;
+        a.re = (ua + uc) * scale;
+        a.im = (va + vc) * scale;
+        c.re = (ua - uc) * scale;
+        c.im = (va - vc) * scale;
 
-        b.re = ub + vd;
-        b.im = vb - ud;
-        d.re = ub - vd;
-        d.im = vb + ud;
+        b.re = (ub + rot * vd) * scale;
+        b.im = (vb - rot * ud) * scale;
+        d.re = (ub - rot * vd) * scale;
+        d.im = (vb + rot * ud) * scale;
     }
-    if (length == 2) return true;
 
 	for (int stage = 2; stage < stages; stage++)
 	{
@@ -155,14 +202,6 @@ bool FFTransformer<FLOAT>::FFTransform(Complex<FLOAT>* data)
 			}
 		}
 	}
-	/*
-	FLOAT rLength = 1.0 / length;
-	for (int i = 0; i < length; i++)
-    {
-        data[i].re *= rLength;
-        data[i].im *= rLength;
-    }
-    */
 	return true;
 }
 
@@ -3,6 +3,8 @@
 
 #include <cmath>
 #include "Complex.h"
+#include "FFTOptions.h"
+#include "FFTBitReverse.h"
 
 typedef unsigned int uint;
 
@@ -12,21 +14,26 @@ class FFTransformer
     private:
         int length;
         int direction;
+        FLOAT scale;
         Complex<FLOAT> *twiddles;
         uint *shuffle_ind;
+        FFTBitReverse<FLOAT> bitReverse;
 
         bool isPowerOfTwo(uint n);
         int getPowerOfTwo(uint n);
         uint bitReverseInt32(uint n);
         void arrayShuffle(Complex<FLOAT> *data, int length);
+        void arrayShuffle(const Complex<FLOAT> *in, Complex<FLOAT> *out, int length);
 
     public:
         FFTransformer();
-        FFTransformer(int fftLength, int direction);
+        FFTransformer(int fftLength, int direction, FFTNormalization normalization = FFT_NORMALIZE_NONE);
         virtual ~FFTransformer();
 
-        bool FFTInit(int fftLength, int direction);
+        bool FFTInit(int fftLength, int direction, FFTNormalization normalization = FFT_NORMALIZE_NONE);
         bool FFTransform(Complex<FLOAT> *data);
+        //out of place, in is left untouched. in == out runs in place
+        bool FFTransform(const Complex<FLOAT> *in, Complex<FLOAT> *out);
 };
 
 #endif // FFTRANSFORMER_H
@@ -0,0 +1,64 @@
+#include "FFTransformer2D.h"
+
+template <class FLOAT>
+bool FFTransformer2D<FLOAT>::isPowerOfTwo(uint n)
+{
+    return ((n - 1) & n) == 0;
+}
+
+template <class FLOAT>
+FFTransformer2D<FLOAT>::FFTransformer2D() : rows(0), cols(0)
+{
+    //do nothing
+}
+
+template <class FLOAT>
+FFTransformer2D<FLOAT>::FFTransformer2D(int fftRows, int fftCols, int direction, FFTNormalization normalization) : rows(0), cols(0)
+{
+    FFTInit(fftRows, fftCols, direction, normalization);
+}
+
+template <class FLOAT>
+FFTransformer2D<FLOAT>::~FFTransformer2D()
+{
+    //do nothing
+}
+
+template <class FLOAT>
+bool FFTransformer2D<FLOAT>::FFTInit(int fftRows, int fftCols, int direction, FFTNormalization normalization)
+{
+    if (fftRows <= 0 || fftCols <= 0 || !isPowerOfTwo(fftRows) || !isPowerOfTwo(fftCols))
+        return false;
+    this->rows = fftRows;
+    this->cols = fftCols;
+    return rowFFT.FFTInit(fftCols, direction, normalization) && colFFT.FFTInit(fftRows, direction, normalization);
+}
+
+template <class FLOAT>
+bool FFTransformer2D<FLOAT>::FFTransform(Complex<FLOAT>* data)
+{
+    return FFTransform(data, data);
+}
+
+template <class FLOAT>
+bool FFTransformer2D<FLOAT>::FFTransform(const Complex<FLOAT>* in, Complex<FLOAT>* out)
+{
+    if (rows <= 0 || cols <= 0) return false;
+    #pragma omp parallel
+    {
+        Complex<FLOAT> *scratch_unalign = new Complex<FLOAT>[cols + 32 / sizeof(Complex<FLOAT>)];
+        Complex<FLOAT> *scratch = (Complex<FLOAT>*)(((size_t)scratch_unalign | 31) + 1);
+        #pragma omp for schedule(static)
+        for (int r = 0; r < rows; r++)
+        {
+            rowFFT.FFTransform(in + (size_t)r * cols, out + (size_t)r * cols, scratch);
+        }
+        delete[] scratch_unalign;
+    }
+    //cols transforms of rows points, element j of column c at out[c + j * cols]
+    return colFFT.FFTransformBatch(out, cols, cols, 1, true);
+}
+
+template class FFTransformer2D<float>;
+template class FFTransformer2D<double>;
+//template class FFTransformer2D<long double>;
@@ -0,0 +1,45 @@
+#ifndef FFTRANSFORMER2D_H
+#define FFTRANSFORMER2D_H
+
+#include <cmath>
+#include "Complex.h"
+#include "FFTOptions.h"
+#include "FFTransformerStockham.h"
+#include "FFTransformerLanes.h"
+
+typedef unsigned int uint;
+
+// Two dimensional FFT of a row major rows x cols matrix, both power of two.
+// The row transforms run on FFTransformerStockham, one row per iteration of a
+// parallel loop. The columns are never gathered: FFTransformerLanes runs them
+// side by side, one column per SIMD lane. Element j of 4 or 8 adjacent columns
+// is then one contiguous run of the row, and it is only split into its real and
+// imaginary parts. Column groups are shared out over the OpenMP threads as well.
+// The row plan applies the normalization for cols points and the column plan
+// the one for rows points, together that of the whole transform.
+// Every thread takes its own scratch, but a plan must still not be used by
+// several transforms at the same time.
+template <class FLOAT>
+class FFTransformer2D
+{
+    private:
+        int rows;
+        int cols;
+        FFTransformerStockham<FLOAT> rowFFT;
+        FFTransformerLanes<FLOAT> colFFT;
+
+        bool isPowerOfTwo(uint n);
+
+    public:
+        FFTransformer2D();
+        FFTransformer2D(int fftRows, int fftCols, int direction, FFTNormalization normalization = FFT_NORMALIZE_NONE);
+        virtual ~FFTransformer2D();
+
+        bool FFTInit(int fftRows, int fftCols, int direction, FFTNormalization normalization = FFT_NORMALIZE_NONE);
+        //data[r * cols + c]
+        bool FFTransform(Complex<FLOAT> *data);
+        //out of place, in is left untouched. in == out runs in place
+        bool FFTransform(const Complex<FLOAT> *in, Complex<FLOAT> *out);
+};
+
+#endif // FFTRANSFORMER2D_H
@@ -0,0 +1,89 @@
+#include "FFTransformer3D.h"
+#include "FFTDispatch.h"
+
+template <class FLOAT>
+bool FFTransformer3D<FLOAT>::isPowerOfTwo(uint n)
+{
+    return ((n - 1) & n) == 0;
+}
+
+template <class FLOAT>
+FFTransformer3D<FLOAT>::FFTransformer3D() : n0(0), n1(0), n2(0)
+{
+    //do nothing
+}
+
+template <class FLOAT>
+FFTransformer3D<FLOAT>::FFTransformer3D(int fftN0, int fftN1, int fftN2, int direction, FFTNormalization normalization) : n0(0), n1(0), n2(0)
+{
+    FFTInit(fftN0, fftN1, fftN2, direction, normalization);
+}
+
+template <class FLOAT>
+FFTransformer3D<FLOAT>::~FFTransformer3D()
+{
+    //do nothing
+}
+
+template <class FLOAT>
+bool FFTransformer3D<FLOAT>::FFTInit(int fftN0, int fftN1, int fftN2, int direction, FFTNormalization normalization)
+{
+    if (fftN0 <= 0 || fftN1 <= 0 || fftN2 <= 0 || !isPowerOfTwo(fftN0) || !isPowerOfTwo(fftN1) || !isPowerOfTwo(fftN2))
+        return false;
+    this->n0 = fftN0;
+    this->n1 = fftN1;
+    this->n2 = fftN2;
+    return fft2.FFTInit(fftN2, direction, normalization) && fft1.FFTInit(fftN1, direction, normalization)
+        && fft0.FFTInit(fftN0, direction, normalization);
+}
+
+template <class FLOAT>
+bool FFTransformer3D<FLOAT>::FFTransform(Complex<FLOAT>* data)
+{
+    return FFTransform(data, data);
+}
+
+template <class FLOAT>
+bool FFTransformer3D<FLOAT>::FFTransform(const Complex<FLOAT>* in, Complex<FLOAT>* out)
+{
+    if (n0 <= 0 || n1 <= 0 || n2 <= 0) return false;
+    const size_t plane = (size_t)n1 * n2;
+    const int groups2 = (n2 + FFT_LANES_MAX - 1) / FFT_LANES_MAX;
+    #pragma omp parallel
+    {
+        int lanes_length = fft1.FFTScratchLength() > fft0.FFTScratchLength() ? fft1.FFTScratchLength() : fft0.FFTScratchLength();
+        Complex<FLOAT> *row_unalign = new Complex<FLOAT>[n2 + 32 / sizeof(Complex<FLOAT>)];
+        FLOAT *lanes_unalign = new FLOAT[lanes_length + 32 / sizeof(FLOAT)];
+        Complex<FLOAT> *row_scratch = (Complex<FLOAT>*)(((size_t)row_unalign | 31) + 1);
+        FLOAT *lanes_scratch = (FLOAT*)(((size_t)lanes_unalign | 31) + 1);
+        //slabs: the 2D transform of every plane i0 on one thread
+        #pragma omp for schedule(static)
+        for (int i0 = 0; i0 < n0; i0++)
+        {
+            const Complex<FLOAT> *src = in + i0 * plane;
+            Complex<FLOAT> *dst = out + i0 * plane;
+            for (int i1 = 0; i1 < n1; i1++)
+            {
+                fft2.FFTransform(src + (size_t)i1 * n2, dst + (size_t)i1 * n2, row_scratch);
+            }
+            fft1.FFTransformBatch(dst, dst, n2, n2, 1, lanes_scratch);
+        }
+        //pencils along i0, the groups of one i1 are adjacent in memory and handed out in order
+        #pragma omp for schedule(static)
+        for (int p = 0; p < n1 * groups2; p++)
+        {
+            int i1 = p / groups2;
+            int first = (p - i1 * groups2) * FFT_LANES_MAX;
+            int count = (n2 - first < FFT_LANES_MAX) ? n2 - first : FFT_LANES_MAX;
+            Complex<FLOAT> *x = out + (size_t)i1 * n2 + first;
+            fft0.FFTransformBatch(x, x, count, (int)plane, 1, lanes_scratch);
+        }
+        delete[] row_unalign;
+        delete[] lanes_unalign;
+    }
+    return true;
+}
+
+template class FFTransformer3D<float>;
+template class FFTransformer3D<double>;
+//template class FFTransformer3D<long double>;
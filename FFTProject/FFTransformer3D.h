@@ -0,0 +1,48 @@
+#ifndef FFTRANSFORMER3D_H
+#define FFTRANSFORMER3D_H
+
+#include <cmath>
+#include "Complex.h"
+#include "FFTOptions.h"
+#include "FFTransformerStockham.h"
+#include "FFTransformerLanes.h"
+
+typedef unsigned int uint;
+
+// Three dimensional FFT of a n0 x n1 x n2 volume, all power of two, stored as
+// data[(i0 * n1 + i1) * n2 + i2]. The volume is cut into n0 slabs of n1 x n2 points
+// that are shared out over the OpenMP threads, each slab gets a 2D transform like
+// that of FFTransformer2D: Stockham rows along i2, then the columns along i1 run by
+// FFTransformerLanes one per SIMD lane. A slab fits the caches of its thread for
+// the sizes of interest, 512^2 floats are 2 MB. The last dimension is done in
+// pencils of FFT_LANES_MAX adjacent i2 along i0, again one per lane: every load of
+// a group is a full cache line and no transpose of the volume is needed.
+// Each of the three plans applies the normalization for its own length.
+// Every thread takes its own scratch, but a plan must still not be used by
+// several transforms at the same time.
+template <class FLOAT>
+class FFTransformer3D
+{
+    private:
+        int n0;
+        int n1;
+        int n2;
+        FFTransformerStockham<FLOAT> fft2;
+        FFTransformerLanes<FLOAT> fft1;
+        FFTransformerLanes<FLOAT> fft0;
+
+        bool isPowerOfTwo(uint n);
+
+    public:
+        FFTransformer3D();
+        FFTransformer3D(int fftN0, int fftN1, int fftN2, int direction, FFTNormalization normalization = FFT_NORMALIZE_NONE);
+        virtual ~FFTransformer3D();
+
+        bool FFTInit(int fftN0, int fftN1, int fftN2, int direction, FFTNormalization normalization = FFT_NORMALIZE_NONE);
+        //data[(i0 * n1 + i1) * n2 + i2]
+        bool FFTransform(Complex<FLOAT> *data);
+        //out of place, in is left untouched. in == out runs in place
+        bool FFTransform(const Complex<FLOAT> *in, Complex<FLOAT> *out);
+};
+
+#endif // FFTRANSFORMER3D_H
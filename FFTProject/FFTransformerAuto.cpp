@@ -0,0 +1,291 @@
+#include <omp.h>
+#include "FFTransformerAuto.h"
+#include "FFTDispatch.h"
+
+const char *FFTEngineName(FFTEngine engine)
+{
+    switch (engine)
+    {
+        case FFT_ENGINE_SCALAR:      return "scalar";
+        case FFT_ENGINE_SPLIT_RADIX: return "split radix";
+        case FFT_ENGINE_VEC:         return "vec";
+        case FFT_ENGINE_STOCKHAM:    return "stockham";
+        case FFT_ENGINE_RECURSIVE:   return "recursive";
+        case FFT_ENGINE_FOUR_STEP:   return "four-step";
+        default:                     return "none";
+    }
+}
+
+template <class FLOAT>
+FFTPlanChoice FFTransformerAuto<FLOAT>::wisdom[32][2];
+
+template <class FLOAT>
+const double FFTransformerAuto<FLOAT>::MEASURE_SECONDS = 0.005;
+
+template <class FLOAT>
+bool FFTransformerAuto<FLOAT>::isPowerOfTwo(uint n)
+{
+    return ((n - 1) & n) == 0;
+}
+
+template <class FLOAT>
+int FFTransformerAuto<FLOAT>::getPowerOfTwo(uint n)
+{
+    return 31 - __builtin_clz(n);
+}
+
+template <class FLOAT>
+FFTransformerAuto<FLOAT>::FFTransformerAuto() : length(0), scalar(0), splitRadix(0), vec(0), stockham(0), recursive(0), fourStep(0)
+{
+    choice.engine = FFT_ENGINE_NONE;
+}
+
+template <class FLOAT>
+FFTransformerAuto<FLOAT>::FFTransformerAuto(int fftLength, int direction, FFTNormalization normalization, FFTPlanMode mode) :
+    length(0), scalar(0), splitRadix(0), vec(0), stockham(0), recursive(0), fourStep(0)
+{
+    choice.engine = FFT_ENGINE_NONE;
+    FFTInit(fftLength, direction, normalization, mode);
+}
+
+template <class FLOAT>
+FFTransformerAuto<FLOAT>::~FFTransformerAuto()
+{
+    release();
+}
+
+template <class FLOAT>
+void FFTransformerAuto<FLOAT>::release()
+{
+    if (this->scalar != 0) delete scalar;
+    if (this->splitRadix != 0) delete splitRadix;
+    if (this->vec != 0) delete vec;
+    if (this->stockham != 0) delete stockham;
+    if (this->recursive != 0) delete recursive;
+    if (this->fourStep != 0) delete fourStep;
+    scalar = 0;
+    splitRadix = 0;
+    vec = 0;
+    stockham = 0;
+    recursive = 0;
+    fourStep = 0;
+}
+
+template <class FLOAT>
+bool FFTransformerAuto<FLOAT>::build(const FFTPlanChoice &plan, int direction, FFTNormalization normalization)
+{
+    release();
+    this->choice = plan;
+    switch (plan.engine)
+    {
+        case FFT_ENGINE_SCALAR:
+            scalar = new FFTransformer<FLOAT>();
+            return scalar->FFTInit(length, direction, normalization);
+        case FFT_ENGINE_SPLIT_RADIX:
+            splitRadix = new FFTransformerSplitRadix<FLOAT>();
+            return splitRadix->FFTInit(length, direction, normalization);
+        case FFT_ENGINE_VEC:
+            vec = new FFTransformerVec<FLOAT>();
+            return vec->FFTInit(length, direction, normalization);
+        case FFT_ENGINE_STOCKHAM:
+            stockham = new FFTransformerStockham<FLOAT>();
+            return stockham->FFTInit(length, direction, normalization);
+        case FFT_ENGINE_RECURSIVE:
+            recursive = new FFTransformerRecursive<FLOAT>();
+            return recursive->FFTSetTuning(plan.branchLength, plan.parallelLength)
+                && recursive->FFTInit(length, direction, normalization);
+        case FFT_ENGINE_FOUR_STEP:
+            fourStep = new FFTransformerFourStep<FLOAT>();
+            return fourStep->FFTInit(length, direction, normalization);
+        default:
+            return false;
+    }
+}
+
+template <class FLOAT>
+FFTPlanChoice FFTransformerAuto<FLOAT>::estimate(int fftLength)
+{
+    //Stockham while the data stays in the L2 cache, the cache oblivious recursion beyond
+    FFTPlanChoice estimated = {FFT_ENGINE_STOCKHAM, 0, 0, omp_get_max_threads(), FFTKernels<FLOAT>().instrset};
+    if ((size_t)fftLength * sizeof(Complex<FLOAT>) > ESTIMATE_STOCKHAM_BYTES)
+    {
+        estimated.engine = FFT_ENGINE_RECURSIVE;
+        estimated.branchLength = 4096;
+        estimated.parallelLength = 65536;
+    }
+    return estimated;
+}
+
+template <class FLOAT>
+double FFTransformerAuto<FLOAT>::measureChoice(const FFTPlanChoice &plan, int direction, Complex<FLOAT>* data)
+{
+    //unitary, so that the repeated transforms of the same data neither overflow nor underflow
+    if (!build(plan, direction, FFT_NORMALIZE_SQRT_N)) return 1e30;
+    FFTransform(data);
+    int repeats = 1;
+    for (;;)
+    {
+        double tStart = omp_get_wtime();
+        for (int i = 0; i < repeats; i++)
+        {
+            FFTransform(data);
+        }
+        double tRun = omp_get_wtime() - tStart;
+        if (tRun >= MEASURE_SECONDS) return tRun / repeats;
+        repeats *= 2;
+    }
+}
+
+template <class FLOAT>
+FFTPlanChoice FFTransformerAuto<FLOAT>::measure(int fftLength, int direction)
+{
+    static const FFTEngine plainEngines[] = {FFT_ENGINE_SCALAR, FFT_ENGINE_SPLIT_RADIX, FFT_ENGINE_VEC, FFT_ENGINE_STOCKHAM, FFT_ENGINE_FOUR_STEP};
+    static const int branchLengths[] = {1024, 2048, 4096, 8192, 16384, 32768};
+    static const int parallelLengths[] = {16384, 65536, 262144};
+    //above the largest task threshold tried, the recursion never spawns tasks
+    static const int serialLength = 1 << 30;
+    Complex<FLOAT> *data_unalign = new Complex<FLOAT>[fftLength + 32 / sizeof(Complex<FLOAT>)];
+    Complex<FLOAT> *data = (Complex<FLOAT>*)(((size_t)data_unalign | 31) + 1);
+    for (int i = 0; i < fftLength; i++)
+    {
+        data[i].re = sin(0.1 * i);
+        data[i].im = cos(0.3 * i);
+    }
+    FFTPlanChoice best = {FFT_ENGINE_NONE, 0, 0, omp_get_max_threads(), FFTKernels<FLOAT>().instrset};
+    FFTPlanChoice candidate = best;
+    double tBest = 1e30;
+    for (int e = 0; e < 5; e++)
+    {
+        //the radix-2 engines lose by far on long transforms, four-step only pays off on them
+        if (plainEngines[e] == FFT_ENGINE_SCALAR || plainEngines[e] == FFT_ENGINE_SPLIT_RADIX)
+        {
+            if (fftLength > 65536) continue;
+        }
+        if (plainEngines[e] == FFT_ENGINE_FOUR_STEP && fftLength < 1048576) continue;
+        candidate.engine = plainEngines[e];
+        double t = measureChoice(candidate, direction, data);
+        if (t < tBest)
+        {
+            tBest = t;
+            best = candidate;
+        }
+    }
+    //the recursive engine only differs from Vec once it branches. The leaf length is
+    //tuned first with the default task threshold, then the threshold for the best leaf
+    candidate.engine = FFT_ENGINE_RECURSIVE;
+    candidate.parallelLength = (omp_get_max_threads() > 1) ? 65536 : serialLength;
+    int bestBranch = 0;
+    double tBestRecursive = 1e30;
+    for (int b = 0; b < 6 && branchLengths[b] < fftLength; b++)
+    {
+        candidate.branchLength = branchLengths[b];
+        double t = measureChoice(candidate, direction, data);
+        if (t < tBestRecursive)
+        {
+            tBestRecursive = t;
+            bestBranch = candidate.branchLength;
+        }
+        if (t < tBest)
+        {
+            tBest = t;
+            best = candidate;
+        }
+    }
+    if (bestBranch != 0 && omp_get_max_threads() > 1)
+    {
+        candidate.branchLength = bestBranch;
+        for (int p = 0; p < 4; p++)
+        {
+            candidate.parallelLength = (p < 3) ? parallelLengths[p] : serialLength;
+            if (candidate.parallelLength == 65536 || (p < 3 && candidate.parallelLength > fftLength)) continue;
+            double t = measureChoice(candidate, direction, data);
+            if (t < tBest)
+            {
+                tBest = t;
+                best = candidate;
+            }
+        }
+    }
+    release();
+    delete[] data_unalign;
+    return best;
+}
+
+template <class FLOAT>
+bool FFTransformerAuto<FLOAT>::FFTInit(int fftLength, int direction, FFTNormalization normalization, FFTPlanMode mode)
+{
+    if (fftLength <= 0 || !isPowerOfTwo(fftLength))
+        return false;
+    this->length = fftLength;
+    if (mode == FFT_PLAN_ESTIMATE)
+    {
+        choice = estimate(fftLength);
+        return build(choice, direction, normalization);
+    }
+    FFTPlanChoice &known = wisdom[getPowerOfTwo(fftLength)][direction > 0 ? 1 : 0];
+    FFTPlanChoice found;
+    #pragma omp critical (FFTransformerAutoWisdom)
+    found = known;
+    if (found.engine != FFT_ENGINE_NONE && found.threads == omp_get_max_threads() && found.instrset == FFTKernels<FLOAT>().instrset)
+    {
+        choice = found;
+    }
+    else
+    {
+        choice = measure(fftLength, direction);
+        #pragma omp critical (FFTransformerAutoWisdom)
+        known = choice;
+    }
+    return build(choice, direction, normalization);
+}
+
+template <class FLOAT>
+bool FFTransformerAuto<FLOAT>::FFTransform(Complex<FLOAT>* data)
+{
+    switch (choice.engine)
+    {
+        case FFT_ENGINE_SCALAR:      return scalar->FFTransform(data);
+        case FFT_ENGINE_SPLIT_RADIX: return splitRadix->FFTransform(data);
+        case FFT_ENGINE_VEC:         return vec->FFTransform(data);
+        case FFT_ENGINE_STOCKHAM:    return stockham->FFTransform(data);
+        case FFT_ENGINE_RECURSIVE:   return recursive->FFTransform(data);
+        case FFT_ENGINE_FOUR_STEP:   return fourStep->FFTransform(data);
+        default:                     return false;
+    }
+}
+
+template <class FLOAT>
+bool FFTransformerAuto<FLOAT>::FFTransform(const Complex<FLOAT>* in, Complex<FLOAT>* out)
+{
+    switch (choice.engine)
+    {
+        case FFT_ENGINE_SCALAR:      return scalar->FFTransform(in, out);
+        case FFT_ENGINE_SPLIT_RADIX: return splitRadix->FFTransform(in, out);
+        case FFT_ENGINE_VEC:         return vec->FFTransform(in, out);
+        case FFT_ENGINE_STOCKHAM:    return stockham->FFTransform(in, out);
+        case FFT_ENGINE_RECURSIVE:   return recursive->FFTransform(in, out);
+        case FFT_ENGINE_FOUR_STEP:   return fourStep->FFTransform(in, out);
+        default:                     return false;
+    }
+}
+
+template <class FLOAT>
+FFTPlanChoice FFTransformerAuto<FLOAT>::FFTGetChoice()
+{
+    return choice;
+}
+
+template <class FLOAT>
+void FFTransformerAuto<FLOAT>::FFTForgetWisdom()
+{
+    #pragma omp critical (FFTransformerAutoWisdom)
+    for (int i = 0; i < 32; i++)
+    {
+        wisdom[i][0].engine = FFT_ENGINE_NONE;
+        wisdom[i][1].engine = FFT_ENGINE_NONE;
+    }
+}
+
+template class FFTransformerAuto<float>;
+template class FFTransformerAuto<double>;
+//template class FFTransformerAuto<long double>;
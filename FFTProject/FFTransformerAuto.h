@@ -0,0 +1,104 @@
+#ifndef FFTRANSFORMERAUTO_H
+#define FFTRANSFORMERAUTO_H
+
+#include <cmath>
+#include "Complex.h"
+#include "FFTOptions.h"
+#include "FFTransformer.h"
+#include "FFTransformerSplitRadix.h"
+#include "FFTransformerVec.h"
+#include "FFTransformerStockham.h"
+#include "FFTransformerRecursive.h"
+#include "FFTransformerFourStep.h"
+
+typedef unsigned int uint;
+
+//power of two engines the planner chooses from
+enum FFTEngine
+{
+    FFT_ENGINE_NONE,
+    FFT_ENGINE_SCALAR,          //FFTransformer
+    FFT_ENGINE_SPLIT_RADIX,     //FFTransformerSplitRadix
+    FFT_ENGINE_VEC,             //FFTransformerVec, radix-8 passes over the whole array
+    FFT_ENGINE_STOCKHAM,        //FFTransformerStockham, radix-4 autosort
+    FFT_ENGINE_RECURSIVE,       //FFTransformerRecursive with its leaf length and task threshold
+    FFT_ENGINE_FOUR_STEP        //FFTransformerFourStep
+};
+
+enum FFTPlanMode
+{
+    FFT_PLAN_ESTIMATE,  //pick from the length alone, no transform is run
+    FFT_PLAN_MEASURE    //time the candidates on this machine, the winner is remembered
+};
+
+const char *FFTEngineName(FFTEngine engine);
+
+struct FFTPlanChoice
+{
+    FFTEngine engine;
+    int branchLength;
+    int parallelLength;
+    //conditions of the measurement, a choice is reused only under the same ones
+    int threads;
+    int instrset;
+};
+
+// Power of two transform that picks its engine at plan time. FFT_PLAN_MEASURE
+// times the engines on the running machine: the scalar, split radix, Vec and
+// Stockham transforms, the recursive one over a range of leaf lengths and task
+// thresholds, and four-step for long transforms. The engines fix the radix
+// sequence, radix-2 for the scalar one, split radix, radix-8 passes for Vec and
+// the recursive leaves, radix-4 for Stockham, so choosing the engine chooses the radix.
+// The candidates run unitary on scratch data, the winner is then built with the
+// requested normalization. Measured choices are kept per length and direction,
+// for each precision, as long as the thread count and kernel level stay the same:
+// later plans of the same transform cost no measurement, but the first one of a
+// long transform takes seconds. FFT_PLAN_ESTIMATE picks from the size of the data
+// alone, for a fast startup: Stockham while it fits the L2 cache, the recursive
+// engine with its default tuning beyond.
+// A plan must not be used by several threads at the same time, like the engines.
+template <class FLOAT>
+class FFTransformerAuto
+{
+    private:
+        int length;
+        FFTPlanChoice choice;
+        FFTransformer<FLOAT> *scalar;
+        FFTransformerSplitRadix<FLOAT> *splitRadix;
+        FFTransformerVec<FLOAT> *vec;
+        FFTransformerStockham<FLOAT> *stockham;
+        FFTransformerRecursive<FLOAT> *recursive;
+        FFTransformerFourStep<FLOAT> *fourStep;
+
+        //measured choices, [log2(length)][direction]
+        static FFTPlanChoice wisdom[32][2];
+
+        //a measurement repeats the transform for at least this long
+        static const double MEASURE_SECONDS;
+        //FFT_PLAN_ESTIMATE takes Stockham up to this many bytes of data
+        static const size_t ESTIMATE_STOCKHAM_BYTES = 524288;
+
+        bool isPowerOfTwo(uint n);
+        int getPowerOfTwo(uint n);
+        void release();
+        bool build(const FFTPlanChoice &plan, int direction, FFTNormalization normalization);
+        FFTPlanChoice estimate(int fftLength);
+        FFTPlanChoice measure(int fftLength, int direction);
+        double measureChoice(const FFTPlanChoice &plan, int direction, Complex<FLOAT> *data);
+
+    public:
+        FFTransformerAuto();
+        FFTransformerAuto(int fftLength, int direction, FFTNormalization normalization = FFT_NORMALIZE_NONE, FFTPlanMode mode = FFT_PLAN_MEASURE);
+        virtual ~FFTransformerAuto();
+
+        bool FFTInit(int fftLength, int direction, FFTNormalization normalization = FFT_NORMALIZE_NONE, FFTPlanMode mode = FFT_PLAN_MEASURE);
+        bool FFTransform(Complex<FLOAT> *data);
+        //out of place, in is left untouched. in == out runs in place
+        bool FFTransform(const Complex<FLOAT> *in, Complex<FLOAT> *out);
+        //the configuration picked by FFTInit
+        FFTPlanChoice FFTGetChoice();
+        //drops the measured choices of this precision, the next plans measure again
+        static void FFTForgetWisdom();
+};
+
+#endif // FFTRANSFORMERAUTO_H
@@ -0,0 +1,136 @@
+#include "FFTransformerBluestein.h"
+
+template <class FLOAT>
+bool FFTransformerBluestein<FLOAT>::isPowerOfTwo(uint n)
+{
+    return ((n - 1) & n) == 0;
+}
+
+template <class FLOAT>
+FFTransformerBluestein<FLOAT>::FFTransformerBluestein() : length(0), convLength(0), chirp(0), kernel_unalign(0), kernel(0), work_unalign(0), work(0)
+{
+    //do nothing
+}
+
+template <class FLOAT>
+FFTransformerBluestein<FLOAT>::FFTransformerBluestein(int fftLength, int direction, FFTNormalization normalization) : length(0), convLength(0), chirp(0), kernel_unalign(0), kernel(0), work_unalign(0), work(0)
+{
+    FFTInit(fftLength, direction, normalization);
+}
+
+template <class FLOAT>
+FFTransformerBluestein<FLOAT>::~FFTransformerBluestein()
+{
+    if (this->chirp != 0)
+    {
+        delete[] chirp;
+    }
+    if (this->kernel_unalign != 0)
+    {
+        delete[] kernel_unalign;
+    }
+    if (this->work_unalign != 0)
+    {
+        delete[] work_unalign;
+    }
+}
+
+template <class FLOAT>
+bool FFTransformerBluestein<FLOAT>::FFTInit(int fftLength, int direction, FFTNormalization normalization)
+{
+    if (fftLength <= 0)
+        return false;
+    this->length = fftLength;
+    this->direction = direction > 0 ? 1 : 0;
+    //the twiddles take the sign of the direction, any positive value is forward
+    int sign = direction > 0 ? 1 : -1;
+    this->scale = FFTNormalizationScale(normalization, fftLength);
+    if (isPowerOfTwo(fftLength))
+    {
+        this->convLength = fftLength;
+        return fft.FFTInit(fftLength, direction, normalization);
+    }
+    int M = 1;
+    while (M < 2 * fftLength - 1)
+    {
+        M *= 2;
+    }
+    this->convLength = M;
+    //both convolution transforms run forward, the inverse one by conjugation
+    if (!fft.FFTInit(M, 1))
+        return false;
+    this->chirp          = new Complex<FLOAT>[fftLength];
+    this->kernel_unalign = new Complex<FLOAT>[M + 32 / sizeof(Complex<FLOAT>)];
+    this->work_unalign   = new Complex<FLOAT>[M + 32 / sizeof(Complex<FLOAT>)];
+    this->kernel = (Complex<FLOAT>*)(((size_t)kernel_unalign | 31) + 1);
+    this->work   = (Complex<FLOAT>*)(((size_t)work_unalign | 31) + 1);
+    //n^2 is reduced modulo 2N before the angle is formed, large n would lose the phase otherwise
+    for (int n = 0; n < fftLength; n++)
+    {
+        long long n2 = (long long)n * n % (2 * (long long)fftLength);
+        double twAngle = -M_PI * sign * n2 / fftLength;
+        chirp[n].re = cos(twAngle);
+        chirp[n].im = sin(twAngle);
+    }
+    //convolution kernel conj(w[n]) for -N < n < N wrapped around M, with the 1/M of
+    //the inverse transform and the plan normalization folded in
+    double kernelScale = scale / (double)M;
+    for (int n = 0; n < M; n++)
+    {
+        kernel[n].re = 0;
+        kernel[n].im = 0;
+    }
+    kernel[0].re = chirp[0].re * kernelScale;
+    kernel[0].im = -chirp[0].im * kernelScale;
+    for (int n = 1; n < fftLength; n++)
+    {
+        kernel[n].re = kernel[M - n].re = chirp[n].re * kernelScale;
+        kernel[n].im = kernel[M - n].im = -chirp[n].im * kernelScale;
+    }
+    fft.FFTransform(kernel);
+    return true;
+}
+
+template <class FLOAT>
+bool FFTransformerBluestein<FLOAT>::FFTransform(Complex<FLOAT>* data)
+{
+    return FFTransform(data, data);
+}
+
+template <class FLOAT>
+bool FFTransformerBluestein<FLOAT>::FFTransform(const Complex<FLOAT>* in, Complex<FLOAT>* data)
+{
+    if (length <= 0) return false;
+    if (convLength == length) return fft.FFTransform(in, data);
+    const int M = convLength;
+    for (int n = 0; n < length; n++)
+    {
+        work[n].re = in[n].re * chirp[n].re - in[n].im * chirp[n].im;
+        work[n].im = in[n].re * chirp[n].im + in[n].im * chirp[n].re;
+    }
+    for (int n = length; n < M; n++)
+    {
+        work[n].re = 0;
+        work[n].im = 0;
+    }
+    fft.FFTransform(work);
+    //pointwise product, conjugated so that the forward transform computes the inverse one
+    for (int k = 0; k < M; k++)
+    {
+        FLOAT re = work[k].re * kernel[k].re - work[k].im * kernel[k].im;
+        FLOAT im = work[k].re * kernel[k].im + work[k].im * kernel[k].re;
+        work[k].re = re;
+        work[k].im = -im;
+    }
+    fft.FFTransform(work);
+    for (int k = 0; k < length; k++)
+    {
+        data[k].re = work[k].re * chirp[k].re + work[k].im * chirp[k].im;
+        data[k].im = work[k].re * chirp[k].im - work[k].im * chirp[k].re;
+    }
+    return true;
+}
+
+template class FFTransformerBluestein<float>;
+template class FFTransformerBluestein<double>;
+//template class FFTransformerBluestein<long double>;
@@ -0,0 +1,48 @@
+#ifndef FFTRANSFORMERBLUESTEIN_H
+#define FFTRANSFORMERBLUESTEIN_H
+
+#include <cmath>
+#include "Complex.h"
+#include "FFTOptions.h"
+#include "FFTransformerStockham.h"
+
+typedef unsigned int uint;
+
+// Transform of any length N through Bluestein's chirp-z algorithm: with
+// w[n] = exp(-i * pi * n^2 / N) the DFT becomes X[k] = w[k] * sum x[n] w[n] conj(w[k - n]),
+// a linear convolution computed by power of two Stockham transforms of length
+// M >= 2N - 1. The chirp and the spectrum of the convolution kernel are
+// prepared by FFTInit, a transform costs two forward FFTs of length M.
+// Power of two lengths go straight to the Stockham engine.
+// The scratch buffer belongs to the plan: one plan must not be used by several
+// threads at the same time.
+template <class FLOAT>
+class FFTransformerBluestein
+{
+    private:
+        int length;
+        int direction;
+        FLOAT scale;
+        int convLength;
+        FFTransformerStockham<FLOAT> fft;
+        Complex<FLOAT> *chirp;
+        Complex<FLOAT> *kernel_unalign;
+        Complex<FLOAT> *kernel;
+        Complex<FLOAT> *work_unalign;
+        Complex<FLOAT> *work;
+
+        bool isPowerOfTwo(uint n);
+
+    public:
+        FFTransformerBluestein();
+        FFTransformerBluestein(int fftLength, int direction, FFTNormalization normalization = FFT_NORMALIZE_NONE);
+        virtual ~FFTransformerBluestein();
+
+        bool FFTInit(int fftLength, int direction, FFTNormalization normalization = FFT_NORMALIZE_NONE);
+        bool FFTransform(Complex<FLOAT> *data);
+        //out of place, in is left untouched. in == out runs in place.
+        //in and out need no alignment beyond that of Complex<FLOAT>
+        bool FFTransform(const Complex<FLOAT> *in, Complex<FLOAT> *out);
+};
+
+#endif // FFTRANSFORMERBLUESTEIN_H
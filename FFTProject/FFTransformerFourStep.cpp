@@ -0,0 +1,189 @@
+#include "FFTransformerFourStep.h"
+
+template <class FLOAT>
+bool FFTransformerFourStep<FLOAT>::isPowerOfTwo(uint n)
+{
+    return ((n - 1) & n) == 0;
+}
+
+template <class FLOAT>
+int FFTransformerFourStep<FLOAT>::getPowerOfTwo(uint n)
+{
+    return 31 - __builtin_clz(n);
+}
+
+//BLOCK columns of the rows src + i * src_step, 0 <= i < rows, into the rows
+//of block at block + b * ld. TILE rows at a time, so that every row of the
+//block is written a cache line at a time
+template <class FLOAT>
+void FFTransformerFourStep<FLOAT>::blockGather(const Complex<FLOAT>* src, int src_step, Complex<FLOAT>* block, int ld, int rows)
+{
+    for (int i = 0; i < rows; i += TILE)
+    {
+        const Complex<FLOAT> *s = src + (size_t)i * src_step;
+        for (int b = 0; b < BLOCK; b++)
+        {
+            Complex<FLOAT> *d = block + b * ld + i;
+            for (int t = 0; t < TILE; t++)
+            {
+                d[t] = s[(size_t)t * src_step + b];
+            }
+        }
+    }
+}
+
+//the inverse of blockGather
+template <class FLOAT>
+void FFTransformerFourStep<FLOAT>::blockScatter(const Complex<FLOAT>* block, int ld, Complex<FLOAT>* dst, int dst_step, int rows)
+{
+    for (int i = 0; i < rows; i += TILE)
+    {
+        Complex<FLOAT> *d = dst + (size_t)i * dst_step;
+        for (int b = 0; b < BLOCK; b++)
+        {
+            const Complex<FLOAT> *s = block + b * ld + i;
+            for (int t = 0; t < TILE; t++)
+            {
+                d[(size_t)t * dst_step + b] = s[t];
+            }
+        }
+    }
+}
+
+template <class FLOAT>
+FFTransformerFourStep<FLOAT>::FFTransformerFourStep() : length(0), length1(0), length2(0), shift2(0), twiddles_lo(0), twiddles_hi(0), work_unalign(0), work(0)
+{
+    //do nothing
+}
+
+template <class FLOAT>
+FFTransformerFourStep<FLOAT>::FFTransformerFourStep(int fftLength, int direction, FFTNormalization normalization) : length(0), length1(0), length2(0), shift2(0), twiddles_lo(0), twiddles_hi(0), work_unalign(0), work(0)
+{
+    FFTInit(fftLength, direction, normalization);
+}
+
+template <class FLOAT>
+FFTransformerFourStep<FLOAT>::~FFTransformerFourStep()
+{
+    if (this->twiddles_lo != 0)
+    {
+        delete[] twiddles_lo;
+    }
+    if (this->twiddles_hi != 0)
+    {
+        delete[] twiddles_hi;
+    }
+    if (this->work_unalign != 0)
+    {
+        delete[] work_unalign;
+    }
+}
+
+template <class FLOAT>
+bool FFTransformerFourStep<FLOAT>::FFTInit(int fftLength, int direction, FFTNormalization normalization)
+{
+    if (fftLength <= 0 || !isPowerOfTwo(fftLength))
+        return false;
+    this->length = fftLength;
+    if (fftLength < BLOCK * BLOCK)
+    {
+        this->length1 = this->length2 = 0;
+        return fft1.FFTInit(fftLength, direction, normalization);
+    }
+    //the column transforms get the longer half
+    int stages = getPowerOfTwo(fftLength);
+    this->shift2  = (stages + 1) / 2;
+    this->length2 = 1 << shift2;
+    this->length1 = fftLength / length2;
+    if (!fft1.FFTInit(length1, direction) || !fft2.FFTInit(length2, direction))
+        return false;
+    //the twiddles take the sign of the direction, any positive value is forward
+    int sign = direction > 0 ? 1 : -1;
+    this->twiddles_lo  = new Complex<FLOAT>[length2];
+    this->twiddles_hi  = new Complex<FLOAT>[length1];
+    this->work_unalign = new Complex<FLOAT>[fftLength + 32 / sizeof(Complex<FLOAT>)];
+    this->work = (Complex<FLOAT>*)(((size_t)work_unalign | 31) + 1);
+    //angles in double, the float tables of long transforms would lose the phase otherwise
+    double scale = FFTNormalizationScale(normalization, fftLength);
+    for (int j = 0; j < length2; j++)
+    {
+        double twAngle = -2 * M_PI * sign * j / fftLength;
+        twiddles_lo[j].re = cos(twAngle);
+        twiddles_lo[j].im = sin(twAngle);
+    }
+    for (int i = 0; i < length1; i++)
+    {
+        double twAngle = -2 * M_PI * sign * (double)i * length2 / fftLength;
+        twiddles_hi[i].re = cos(twAngle) * scale;
+        twiddles_hi[i].im = sin(twAngle) * scale;
+    }
+    return true;
+}
+
+template <class FLOAT>
+bool FFTransformerFourStep<FLOAT>::FFTransform(Complex<FLOAT>* data)
+{
+    return FFTransform(data, data);
+}
+
+template <class FLOAT>
+bool FFTransformerFourStep<FLOAT>::FFTransform(const Complex<FLOAT>* in, Complex<FLOAT>* out)
+{
+    if (length <= 0) return false;
+    if (length2 == 0) return fft1.FFTransform(in, out);
+    #pragma omp parallel
+    {
+        //a block of BLOCK rows of up to length2 points and the Stockham scratch, per thread.
+        //The rows are padded, at a power of two apart the gathers would hit the same cache sets
+        const int ld = length2 + PAD;
+        Complex<FLOAT> *block_unalign = new Complex<FLOAT>[BLOCK * ld + 32 / sizeof(Complex<FLOAT>)];
+        Complex<FLOAT> *scratch_unalign = new Complex<FLOAT>[length2 + 32 / sizeof(Complex<FLOAT>)];
+        Complex<FLOAT> *block = (Complex<FLOAT>*)(((size_t)block_unalign | 31) + 1);
+        Complex<FLOAT> *scratch = (Complex<FLOAT>*)(((size_t)scratch_unalign | 31) + 1);
+        const int mask2 = length2 - 1;
+
+        //step 1: columns c .. c + BLOCK - 1 of in, transformed and twiddled into work
+        #pragma omp for schedule(static)
+        for (int c = 0; c < length1; c += BLOCK)
+        {
+            blockGather(in + c, length1, block, ld, length2);
+            for (int b = 0; b < BLOCK; b++)
+            {
+                Complex<FLOAT> *x = block + b * ld;
+                fft2.FFTransform(x, x, scratch);
+                //W_N^(n1 k2), n1 k2 < N needs no reduction
+                const int n1 = c + b;
+                int e = 0;
+                for (int k2 = 0; k2 < length2; k2++, e += n1)
+                {
+                    const Complex<FLOAT> lo = twiddles_lo[e & mask2];
+                    const Complex<FLOAT> hi = twiddles_hi[e >> shift2];
+                    FLOAT w_re = lo.re * hi.re - lo.im * hi.im;
+                    FLOAT w_im = lo.re * hi.im + lo.im * hi.re;
+                    FLOAT re = x[k2].re * w_re - x[k2].im * w_im;
+                    x[k2].im = x[k2].re * w_im + x[k2].im * w_re;
+                    x[k2].re = re;
+                }
+            }
+            blockScatter(block, ld, work + c, length1, length2);
+        }
+
+        //step 2: rows r .. r + BLOCK - 1 of work, stored as columns of out
+        #pragma omp for schedule(static)
+        for (int r = 0; r < length2; r += BLOCK)
+        {
+            for (int b = 0; b < BLOCK; b++)
+            {
+                fft1.FFTransform(work + (size_t)(r + b) * length1, block + b * ld, scratch);
+            }
+            blockScatter(block, ld, out + r, length2, length1);
+        }
+        delete[] block_unalign;
+        delete[] scratch_unalign;
+    }
+    return true;
+}
+
+template class FFTransformerFourStep<float>;
+template class FFTransformerFourStep<double>;
+//template class FFTransformerFourStep<long double>;
@@ -0,0 +1,63 @@
+#ifndef FFTRANSFORMERFOURSTEP_H
+#define FFTRANSFORMERFOURSTEP_H
+
+#include <cmath>
+#include "Complex.h"
+#include "FFTOptions.h"
+#include "FFTransformerStockham.h"
+
+typedef unsigned int uint;
+
+// Four-step FFT for transforms larger than the last level cache. The N points
+// are seen as a matrix of length2 rows and length1 columns, x[n1 + length1 * n2]:
+//  1. length2 point FFTs of the columns, times the twiddles W_N^(n1 k2)
+//  2. length1 point FFTs of the rows, stored transposed: X[k2 + length2 * k1]
+// Both steps work on blocks of BLOCK adjacent columns, so every row touched
+// is one contiguous run of BLOCK points. The block is gathered into a
+// buffer, transformed there with FFTransformerStockham and written back. The
+// transposes are fused into these two passes. A transform costs two sweeps
+// over memory, in to a scratch array of N points and from it to out. Blocks
+// are shared out over the OpenMP threads. Lengths below BLOCK * BLOCK go
+// straight to the Stockham engine.
+// The scratch array belongs to the plan: one plan must not be used by several
+// threads at the same time.
+template <class FLOAT>
+class FFTransformerFourStep
+{
+    private:
+        int length;
+        int length1;
+        int length2;
+        int shift2;
+        FFTransformerStockham<FLOAT> fft1;
+        FFTransformerStockham<FLOAT> fft2;
+        //W_N^e = twiddles_hi[e >> shift2] * twiddles_lo[e & (length2 - 1)], the normalization is in twiddles_hi
+        Complex<FLOAT> *twiddles_lo;
+        Complex<FLOAT> *twiddles_hi;
+        Complex<FLOAT> *work_unalign;
+        Complex<FLOAT> *work;
+
+        //points per row of a block, 256 bytes of float data
+        static const int BLOCK = 32;
+        //rows moved together by blockGather and blockScatter
+        static const int TILE = 8;
+        //padding of the block rows, keeps them 32 byte aligned
+        static const int PAD = 8;
+
+        bool isPowerOfTwo(uint n);
+        int getPowerOfTwo(uint n);
+        void blockGather(const Complex<FLOAT> *src, int src_step, Complex<FLOAT> *block, int ld, int rows);
+        void blockScatter(const Complex<FLOAT> *block, int ld, Complex<FLOAT> *dst, int dst_step, int rows);
+
+    public:
+        FFTransformerFourStep();
+        FFTransformerFourStep(int fftLength, int direction, FFTNormalization normalization = FFT_NORMALIZE_NONE);
+        virtual ~FFTransformerFourStep();
+
+        bool FFTInit(int fftLength, int direction, FFTNormalization normalization = FFT_NORMALIZE_NONE);
+        bool FFTransform(Complex<FLOAT> *data);
+        //out of place, in is left untouched. in == out runs in place
+        bool FFTransform(const Complex<FLOAT> *in, Complex<FLOAT> *out);
+};
+
+#endif // FFTRANSFORMERFOURSTEP_H
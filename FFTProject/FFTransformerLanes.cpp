@@ -0,0 +1,163 @@
+#include "FFTransformerLanes.h"
+#include "FFTDispatch.h"
+
+template <class FLOAT>
+bool FFTransformerLanes<FLOAT>::isPowerOfTwo(uint n)
+{
+    return ((n - 1) & n) == 0;
+}
+
+template <class FLOAT>
+FFTransformerLanes<FLOAT>::FFTransformerLanes() : length(0), twiddles_unalign(0), twiddles(0), work_unalign(0), work(0)
+{
+    //do nothing
+}
+
+template <class FLOAT>
+FFTransformerLanes<FLOAT>::FFTransformerLanes(int fftLength, int direction, FFTNormalization normalization) : length(0), twiddles_unalign(0), twiddles(0), work_unalign(0), work(0)
+{
+    FFTInit(fftLength, direction, normalization);
+}
+
+template <class FLOAT>
+FFTransformerLanes<FLOAT>::~FFTransformerLanes()
+{
+    if (this->twiddles_unalign != 0)
+    {
+        delete[] twiddles_unalign;
+    }
+    if (this->work_unalign != 0)
+    {
+        delete[] work_unalign;
+    }
+}
+
+template <class FLOAT>
+bool FFTransformerLanes<FLOAT>::FFTInit(int fftLength, int direction, FFTNormalization normalization)
+{
+    if (fftLength > 0 && isPowerOfTwo(fftLength))
+    {
+        this->length = fftLength;
+        this->direction = direction > 0 ? 1 : 0;
+        //the twiddles take the sign of the direction, any positive value is forward
+        int sign = direction > 0 ? 1 : -1;
+        this->scale = FFTNormalizationScale(normalization, fftLength);
+        //two lane buffers for the widest group, the twiddle layout is that of FFTransformerStockham
+        this->twiddles_unalign = new Complex<FLOAT>[fftLength + 1 + 32 / sizeof(Complex<FLOAT>)];
+        this->work_unalign     = new FLOAT[FFTScratchLength() + 32 / sizeof(FLOAT)];
+        this->twiddles = (Complex<FLOAT>*)(((size_t)twiddles_unalign | 31) + 1);
+        this->work     = (FLOAT*)(((size_t)work_unalign | 31) + 1);
+        Complex<FLOAT> *tw = twiddles;
+        int n = fftLength;
+        for (; n >= 4; n /= 4)
+        {
+            int m = n / 4;
+            for (int k = 1; k <= 3; k++)
+            {
+                for (int p = 0; p < m; p++)
+                {
+                    FLOAT twAngle = -2 * M_PI * sign * k * p / n;
+                    tw[(k - 1) * m + p].re = cos(twAngle);
+                    tw[(k - 1) * m + p].im = sin(twAngle);
+                }
+            }
+            tw += 3 * m;
+        }
+        if (n == 2)
+        {
+            tw[0].re = 1;
+            tw[0].im = 0;
+        }
+        return true;
+    }
+    else
+        return false;
+}
+
+template <class FLOAT>
+bool FFTransformerLanes<FLOAT>::FFTransform(Complex<FLOAT>* data)
+{
+    return FFTransform(data, data);
+}
+
+template <class FLOAT>
+bool FFTransformerLanes<FLOAT>::FFTransform(const Complex<FLOAT>* in, Complex<FLOAT>* out)
+{
+    if (length <= 0 || !isPowerOfTwo(length)) return false;
+    if (length == 1)
+    {
+        out[0].re = in[0].re * scale;
+        out[0].im = in[0].im * scale;
+        return true;
+    }
+    //the transform is read into the lane buffer before anything is written, in may equal out
+    FFTKernels<FLOAT>().lanesBatch(in, out, length, 1, 1, length, twiddles, work, direction, scale);
+    return true;
+}
+
+template <class FLOAT>
+bool FFTransformerLanes<FLOAT>::FFTransformBatch(Complex<FLOAT>* data, int howmany, int stride, int dist, bool parallel)
+{
+    if (length <= 0 || !isPowerOfTwo(length) || howmany < 0 || stride < 1) return false;
+    if (dist == 0) dist = length * stride;
+    if (length == 1)
+    {
+        for (int i = 0; i < howmany; i++)
+        {
+            data[(size_t)i * dist].re *= scale;
+            data[(size_t)i * dist].im *= scale;
+        }
+        return true;
+    }
+    const FFTKernelTable<FLOAT> &kernels = FFTKernels<FLOAT>();
+    if (!parallel)
+    {
+        kernels.lanesBatch(data, data, length, howmany, stride, dist, twiddles, work, direction, scale);
+        return true;
+    }
+    //groups of FFT_LANES_MAX transforms fill the lanes of every instruction set
+    const int groups = (howmany + FFT_LANES_MAX - 1) / FFT_LANES_MAX;
+    #pragma omp parallel
+    {
+        FLOAT *work_thread_unalign = new FLOAT[FFTScratchLength() + 32 / sizeof(FLOAT)];
+        FLOAT *work_thread = (FLOAT*)(((size_t)work_thread_unalign | 31) + 1);
+        #pragma omp for schedule(static)
+        for (int g = 0; g < groups; g++)
+        {
+            const int first = g * FFT_LANES_MAX;
+            const int count = (howmany - first < FFT_LANES_MAX) ? howmany - first : FFT_LANES_MAX;
+            Complex<FLOAT> *x = data + (size_t)first * dist;
+            kernels.lanesBatch(x, x, length, count, stride, dist, twiddles, work_thread, direction, scale);
+        }
+        delete[] work_thread_unalign;
+    }
+    return true;
+}
+
+template <class FLOAT>
+bool FFTransformerLanes<FLOAT>::FFTransformBatch(const Complex<FLOAT>* in, Complex<FLOAT>* out, int howmany, int stride, int dist, FLOAT* scratch)
+{
+    if (length <= 0 || !isPowerOfTwo(length) || howmany < 0 || stride < 1) return false;
+    if (dist == 0) dist = length * stride;
+    if (length == 1)
+    {
+        for (int i = 0; i < howmany; i++)
+        {
+            out[(size_t)i * dist].re = in[(size_t)i * dist].re * scale;
+            out[(size_t)i * dist].im = in[(size_t)i * dist].im * scale;
+        }
+        return true;
+    }
+    FFTKernels<FLOAT>().lanesBatch(in, out, length, howmany, stride, dist, twiddles, scratch, direction, scale);
+    return true;
+}
+
+template <class FLOAT>
+int FFTransformerLanes<FLOAT>::FFTScratchLength()
+{
+    return 4 * FFT_LANES_MAX * (length + 4);
+}
+
+template class FFTransformerLanes<float>;
+template class FFTransformerLanes<double>;
+//template class FFTransformerLanes<long double>;
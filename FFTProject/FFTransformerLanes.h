@@ -0,0 +1,52 @@
+#ifndef FFTRANSFORMERLANES_H
+#define FFTRANSFORMERLANES_H
+
+#include <cmath>
+#include "Complex.h"
+#include "FFTOptions.h"
+
+typedef unsigned int uint;
+
+// Batches of many short power of two transforms with one transform per SIMD
+// lane: 4 (SSE, and Vec4d for double) or 8 (AVX) transforms are transposed
+// into a buffer where every vector holds the same element of all of them, split
+// into real and imaginary parts. The Stockham steps then run as plain vertical
+// arithmetic with broadcast twiddles, without the permutes and the special first
+// stage of the horizontal kernels. Meant for lengths of about 16 to 256, where
+// the two lane buffers stay in L1; a single transform leaves most lanes idle.
+// The scratch buffers belong to the plan: one plan must not be used by several
+// threads at the same time, a parallel FFTransformBatch gives every thread its own.
+template <class FLOAT>
+class FFTransformerLanes
+{
+    private:
+        int length;
+        int direction;
+        FLOAT scale;
+        Complex<FLOAT> *twiddles_unalign;
+        Complex<FLOAT> *twiddles;
+        FLOAT *work_unalign;
+        FLOAT *work;
+
+        bool isPowerOfTwo(uint n);
+
+    public:
+        FFTransformerLanes();
+        FFTransformerLanes(int fftLength, int direction, FFTNormalization normalization = FFT_NORMALIZE_NONE);
+        virtual ~FFTransformerLanes();
+
+        bool FFTInit(int fftLength, int direction, FFTNormalization normalization = FFT_NORMALIZE_NONE);
+        bool FFTransform(Complex<FLOAT> *data);
+        //out of place, in is left untouched. in == out runs in place
+        bool FFTransform(const Complex<FLOAT> *in, Complex<FLOAT> *out);
+        //howmany transforms, element j of transform i at data[i * dist + j * stride].
+        //dist 0 means length * stride. With parallel set the groups of transforms
+        //are shared out over the OpenMP threads
+        bool FFTransformBatch(Complex<FLOAT> *data, int howmany, int stride = 1, int dist = 0, bool parallel = false);
+        //out of place batch with a caller owned scratch of FFTScratchLength() FLOATs, 32 byte
+        //aligned, in place of the one of the plan. Threads that bring their own scratch may share the plan
+        bool FFTransformBatch(const Complex<FLOAT> *in, Complex<FLOAT> *out, int howmany, int stride, int dist, FLOAT *scratch);
+        int FFTScratchLength();
+};
+
+#endif // FFTRANSFORMERLANES_H
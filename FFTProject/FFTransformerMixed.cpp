@@ -0,0 +1,208 @@
+#include "FFTransformerMixed.h"
+#include "FFTDispatch.h"
+#include "FFTBatch.h"
+
+//fills radices, returns the number of steps or 0 if n has a prime factor above 7
+template <class FLOAT>
+int FFTransformerMixed<FLOAT>::factorize(int n)
+{
+    static const int odd[] = {3, 5, 7};
+    int cnt = 0;
+    while (n % 4 == 0)
+    {
+        radices[cnt++] = 4;
+        n /= 4;
+    }
+    if (n % 2 == 0)
+    {
+        radices[cnt++] = 2;
+        n /= 2;
+    }
+    for (int i = 0; i < 3; i++)
+    {
+        while (n % odd[i] == 0)
+        {
+            radices[cnt++] = odd[i];
+            n /= odd[i];
+        }
+    }
+    return n == 1 ? cnt : 0;
+}
+
+template <class FLOAT>
+FFTransformerMixed<FLOAT>::FFTransformerMixed() : length(0), steps(0), twiddles_unalign(0), twiddles(0), work_unalign(0), work(0)
+{
+    //do nothing
+}
+
+template <class FLOAT>
+FFTransformerMixed<FLOAT>::FFTransformerMixed(int fftLength, int direction, FFTNormalization normalization) : length(0), steps(0), twiddles_unalign(0), twiddles(0), work_unalign(0), work(0)
+{
+    FFTInit(fftLength, direction, normalization);
+}
+
+template <class FLOAT>
+FFTransformerMixed<FLOAT>::~FFTransformerMixed()
+{
+    if (this->twiddles_unalign != 0)
+    {
+        delete[] twiddles_unalign;
+    }
+    if (this->work_unalign != 0)
+    {
+        delete[] work_unalign;
+    }
+}
+
+template <class FLOAT>
+bool FFTransformerMixed<FLOAT>::FFTInit(int fftLength, int direction, FFTNormalization normalization)
+{
+    if (fftLength <= 0)
+        return false;
+    int cnt = factorize(fftLength);
+    if (cnt == 0 && fftLength > 1)
+        return false;
+    this->length = fftLength;
+    this->direction = direction > 0 ? 1 : 0;
+    //the twiddles take the sign of the direction, any positive value is forward
+    int sign = direction > 0 ? 1 : -1;
+    this->scale = FFTNormalizationScale(normalization, fftLength);
+    this->steps = cnt;
+    //(r - 1) * n / r twiddles per step sum up to less than N, every step is padded to 4 entries
+    int twLength = fftLength + 4 * cnt;
+    this->twiddles_unalign = new Complex<FLOAT>[twLength + 32 / sizeof(Complex<FLOAT>)];
+    this->work_unalign     = new Complex<FLOAT>[fftLength + 32 / sizeof(Complex<FLOAT>)];
+    this->twiddles = (Complex<FLOAT>*)(((size_t)twiddles_unalign | 31) + 1);
+    this->work     = (Complex<FLOAT>*)(((size_t)work_unalign | 31) + 1);
+    Complex<FLOAT> *tw = twiddles;
+    int n = fftLength;
+    for (int step = 0; step < cnt; step++)
+    {
+        int r = radices[step];
+        int m = n / r;
+        for (int k = 1; k < r; k++)
+        {
+            for (int p = 0; p < m; p++)
+            {
+                double twAngle = -2 * M_PI * sign * k * p / n;
+                tw[(k - 1) * m + p].re = cos(twAngle);
+                tw[(k - 1) * m + p].im = sin(twAngle);
+            }
+        }
+        tw += ((r - 1) * m + 3) & ~3;
+        n = m;
+    }
+    return true;
+}
+
+template <class FLOAT>
+bool FFTransformerMixed<FLOAT>::FFTransform(Complex<FLOAT>* data)
+{
+    return FFTransform(data, data);
+}
+
+template <class FLOAT>
+bool FFTransformerMixed<FLOAT>::FFTransform(const Complex<FLOAT>* in, Complex<FLOAT>* data)
+{
+    if (length <= 0) return false;
+    if (steps == 0)
+    {
+        data[0] = in[0];
+        return true;
+    }
+    transform(in, data, work, FFTKernels<FLOAT>());
+    return true;
+}
+
+template <class FLOAT>
+void FFTransformerMixed<FLOAT>::transform(const Complex<FLOAT>* in, Complex<FLOAT>* data, Complex<FLOAT>* scratch, const FFTKernelTable<FLOAT> &kernels)
+{
+    //out of place the first step reads in, and the ping-pong starts on the
+    //buffer that makes the last step land in data
+    const Complex<FLOAT> *src = in;
+    Complex<FLOAT> *dst = (in != data && steps % 2 == 1) ? data : scratch;
+    const Complex<FLOAT> *tw = twiddles;
+    int n = length;
+    int s = 1;
+    for (int step = 0; step < steps; step++)
+    {
+        int r = radices[step];
+        int m = n / r;
+        //the last step has a single butterfly group and may write back in place,
+        //it also applies the normalization
+        FLOAT step_scale = 1;
+        if (step == steps - 1)
+        {
+            dst = data;
+            step_scale = scale;
+        }
+        if (r == 4)
+            kernels.stockhamPass4(src, dst, n, s, tw, direction, step_scale);
+        else if (r == 2)
+            kernels.stockhamPass2(src, dst, n, s, tw, step_scale);
+        else
+            kernels.stockhamPassOdd(src, dst, n, s, r, tw, direction, step_scale);
+        tw += ((r - 1) * m + 3) & ~3;
+        n = m;
+        s *= r;
+        src = dst;
+        dst = (dst == scratch) ? data : scratch;
+    }
+}
+
+template <class FLOAT>
+bool FFTransformerMixed<FLOAT>::FFTransformBatch(Complex<FLOAT>* data, int howmany, int stride, int dist, bool parallel)
+{
+    if (length <= 0 || howmany < 0 || stride < 1) return false;
+    if (length == 1) return true;
+    if (dist == 0) dist = length * stride;
+    //checks and kernel table lookup once for the whole batch
+    const FFTKernelTable<FLOAT> &kernels = FFTKernels<FLOAT>();
+    #pragma omp parallel if (parallel)
+    {
+        //the scratch buffer of the plan is shared, every thread of a parallel batch takes its own
+        Complex<FLOAT> *work_unalign_thread = 0;
+        Complex<FLOAT> *work_thread = work;
+        if (parallel)
+        {
+            work_unalign_thread = new Complex<FLOAT>[length + 32 / sizeof(Complex<FLOAT>)];
+            work_thread = (Complex<FLOAT>*)(((size_t)work_unalign_thread | 31) + 1);
+        }
+        Complex<FLOAT> *copy_unalign = 0;
+        Complex<FLOAT> *copy = 0;
+        if (stride != 1)
+        {
+            copy_unalign = new Complex<FLOAT>[length + 32 / sizeof(Complex<FLOAT>)];
+            copy = (Complex<FLOAT>*)(((size_t)copy_unalign | 31) + 1);
+        }
+        #pragma omp for schedule(static)
+        for (int i = 0; i < howmany; i++)
+        {
+            Complex<FLOAT> *x = data + (size_t)i * dist;
+            if (stride == 1)
+            {
+                if (i + 1 < howmany) FFTBatchPrefetch(x + dist, length);
+                transform(x, x, work_thread, kernels);
+            }
+            else
+            {
+                FFTBatchGather(x, stride, copy, length);
+                transform(copy, copy, work_thread, kernels);
+                FFTBatchScatter(copy, x, stride, length);
+            }
+        }
+        if (copy_unalign != 0)
+        {
+            delete[] copy_unalign;
+        }
+        if (work_unalign_thread != 0)
+        {
+            delete[] work_unalign_thread;
+        }
+    }
+    return true;
+}
+
+template class FFTransformerMixed<float>;
+template class FFTransformerMixed<double>;
+//template class FFTransformerMixed<long double>;
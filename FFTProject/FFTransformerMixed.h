@@ -0,0 +1,55 @@
+#ifndef FFTRANSFORMERMIXED_H
+#define FFTRANSFORMERMIXED_H
+
+#include <cmath>
+#include "Complex.h"
+#include "FFTOptions.h"
+
+typedef unsigned int uint;
+
+template <class FLOAT>
+struct FFTKernelTable;
+
+// Mixed radix Stockham FFT for lengths 2^a * 3^b * 5^c * 7^d. The planner
+// factorizes N into radix-4 and radix-2 steps first, which leaves the odd radix
+// steps with a stride that is a multiple of the vector width, then radix 3, 5
+// and 7 steps. Like FFTransformerStockham the steps ping-pong between data and
+// a scratch buffer and the result ends up in natural order in data.
+// The scratch buffer belongs to the plan: one plan must not be used by several
+// threads at the same time. A parallel FFTransformBatch gives every thread its own.
+template <class FLOAT>
+class FFTransformerMixed
+{
+    private:
+        static const int MAX_STEPS = 32;
+
+        int length;
+        int direction;
+        FLOAT scale;
+        int steps;
+        int radices[MAX_STEPS];
+        Complex<FLOAT> *twiddles_unalign;
+        Complex<FLOAT> *twiddles;
+        Complex<FLOAT> *work_unalign;
+        Complex<FLOAT> *work;
+
+        int factorize(int n);
+        void transform(const Complex<FLOAT> *in, Complex<FLOAT> *out, Complex<FLOAT> *scratch, const FFTKernelTable<FLOAT> &kernels);
+
+    public:
+        FFTransformerMixed();
+        FFTransformerMixed(int fftLength, int direction, FFTNormalization normalization = FFT_NORMALIZE_NONE);
+        virtual ~FFTransformerMixed();
+
+        bool FFTInit(int fftLength, int direction, FFTNormalization normalization = FFT_NORMALIZE_NONE);
+        bool FFTransform(Complex<FLOAT> *data);
+        //out of place, in is left untouched. in == out runs in place.
+        //in and out need no alignment beyond that of Complex<FLOAT>
+        bool FFTransform(const Complex<FLOAT> *in, Complex<FLOAT> *out);
+        //howmany transforms, element j of transform i at data[i * dist + j * stride], see FFTBatch.h.
+        //parallel spreads the batch over the OpenMP threads. Any dist will do, the transforms
+        //need no alignment beyond that of Complex<FLOAT>
+        bool FFTransformBatch(Complex<FLOAT> *data, int howmany, int stride = 1, int dist = 0, bool parallel = false);
+};
+
+#endif // FFTRANSFORMERMIXED_H
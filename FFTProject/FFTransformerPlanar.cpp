@@ -0,0 +1,149 @@
+#include "FFTransformerPlanar.h"
+#include "FFTDispatch.h"
+
+template <class FLOAT>
+bool FFTransformerPlanar<FLOAT>::isPowerOfTwo(uint n)
+{
+    return ((n - 1) & n) == 0;
+}
+
+template <class FLOAT>
+int FFTransformerPlanar<FLOAT>::getPowerOfTwo(uint n)
+{
+    return 31 - __builtin_clz(n);
+}
+
+template <class FLOAT>
+FFTransformerPlanar<FLOAT>::FFTransformerPlanar() : length(0), twiddles_unalign(0), twiddles_re(0), twiddles_im(0), work_unalign(0), work_re(0), work_im(0)
+{
+    //do nothing
+}
+
+template <class FLOAT>
+FFTransformerPlanar<FLOAT>::FFTransformerPlanar(int fftLength, int direction, FFTNormalization normalization) : length(0), twiddles_unalign(0), twiddles_re(0), twiddles_im(0), work_unalign(0), work_re(0), work_im(0)
+{
+    FFTInit(fftLength, direction, normalization);
+}
+
+template <class FLOAT>
+FFTransformerPlanar<FLOAT>::~FFTransformerPlanar()
+{
+    if (this->twiddles_unalign != 0)
+    {
+        delete[] twiddles_unalign;
+    }
+    if (this->work_unalign != 0)
+    {
+        delete[] work_unalign;
+    }
+}
+
+template <class FLOAT>
+bool FFTransformerPlanar<FLOAT>::FFTInit(int fftLength, int direction, FFTNormalization normalization)
+{
+    if (fftLength > 0 && isPowerOfTwo(fftLength))
+    {
+        this->length = fftLength;
+        this->direction = direction > 0 ? 1 : 0;
+        //the twiddles take the sign of the direction, any positive value is forward
+        int sign = direction > 0 ? 1 : -1;
+        this->scale = FFTNormalizationScale(normalization, fftLength);
+        //real and imaginary halves of one allocation each, both 32 byte aligned.
+        //The twiddle layout is that of FFTransformerStockham
+        int twLength = (fftLength + 1 + 7) & ~7;
+        this->twiddles_unalign = new FLOAT[2 * twLength + 32 / sizeof(FLOAT)];
+        this->work_unalign     = new FLOAT[2 * fftLength + 8 + 32 / sizeof(FLOAT)];
+        this->twiddles_re = (FLOAT*)(((size_t)twiddles_unalign | 31) + 1);
+        this->twiddles_im = twiddles_re + twLength;
+        this->work_re     = (FLOAT*)(((size_t)work_unalign | 31) + 1);
+        this->work_im     = work_re + ((fftLength + 7) & ~7);
+        FLOAT *tw_re = twiddles_re;
+        FLOAT *tw_im = twiddles_im;
+        int n = fftLength;
+        for (; n >= 4; n /= 4)
+        {
+            int m = n / 4;
+            for (int k = 1; k <= 3; k++)
+            {
+                for (int p = 0; p < m; p++)
+                {
+                    FLOAT twAngle = -2 * M_PI * sign * k * p / n;
+                    tw_re[(k - 1) * m + p] = cos(twAngle);
+                    tw_im[(k - 1) * m + p] = sin(twAngle);
+                }
+            }
+            tw_re += 3 * m;
+            tw_im += 3 * m;
+        }
+        if (n == 2)
+        {
+            tw_re[0] = 1;
+            tw_im[0] = 0;
+        }
+        return true;
+    }
+    else
+        return false;
+}
+
+template <class FLOAT>
+bool FFTransformerPlanar<FLOAT>::FFTransform(FLOAT* re, FLOAT* im)
+{
+    return FFTransform(re, im, re, im);
+}
+
+template <class FLOAT>
+bool FFTransformerPlanar<FLOAT>::FFTransform(const FLOAT* in_re, const FLOAT* in_im, FLOAT* re, FLOAT* im)
+{
+    if (length <= 0 || !isPowerOfTwo(length)) return false;
+    if (length == 1)
+    {
+        re[0] = in_re[0] * scale;
+        im[0] = in_im[0] * scale;
+        return true;
+    }
+    const FFTKernelTable<FLOAT> &kernels = FFTKernels<FLOAT>();
+    int stages = getPowerOfTwo(length);
+    //out of place the ping-pong starts on the buffer that makes the last step land in re, im
+    const bool outOfPlace = in_re != re;
+    const FLOAT *src_re = in_re, *src_im = in_im;
+    FLOAT *dst_re = work_re, *dst_im = work_im;
+    if (outOfPlace && (stages + 1) / 2 % 2 == 1)
+    {
+        dst_re = re;
+        dst_im = im;
+    }
+    const FLOAT *tw_re = twiddles_re;
+    const FLOAT *tw_im = twiddles_im;
+    int n = length;
+    int s = 1;
+    for (; stages >= 2; stages -= 2)
+    {
+        //the last step may write back in place, it also applies the normalization
+        FLOAT step_scale = 1;
+        if (n == 4)
+        {
+            dst_re = re;
+            dst_im = im;
+            if (stages == 2) step_scale = scale;
+        }
+        kernels.planarPass4(src_re, src_im, dst_re, dst_im, n, s, tw_re, tw_im, direction, step_scale);
+        tw_re += 3 * (n / 4);
+        tw_im += 3 * (n / 4);
+        n /= 4;
+        s *= 4;
+        src_re = dst_re;
+        src_im = dst_im;
+        dst_re = (dst_re == work_re) ? re : work_re;
+        dst_im = (dst_im == work_im) ? im : work_im;
+    }
+    if (stages == 1)
+    {
+        kernels.planarPass2(src_re, src_im, re, im, n, s, tw_re, tw_im, scale);
+    }
+    return true;
+}
+
+template class FFTransformerPlanar<float>;
+template class FFTransformerPlanar<double>;
+//template class FFTransformerPlanar<long double>;
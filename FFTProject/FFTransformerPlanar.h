@@ -0,0 +1,45 @@
+#ifndef FFTRANSFORMERPLANAR_H
+#define FFTRANSFORMERPLANAR_H
+
+#include <cmath>
+#include "FFTOptions.h"
+
+typedef unsigned int uint;
+
+// Stockham autosort FFT on planar data: the real and imaginary parts live in
+// two separate arrays instead of interleaved Complex<FLOAT>. Every vector then
+// holds only real or only imaginary parts, the butterflies and twiddle products
+// are plain vertical arithmetic without the lane permutes of the interleaved
+// kernels. The steps are those of FFTransformerStockham, the result ends up in
+// natural order in re and im.
+// The scratch buffers belong to the plan: one plan must not be used by several
+// threads at the same time.
+template <class FLOAT>
+class FFTransformerPlanar
+{
+    private:
+        int length;
+        int direction;
+        FLOAT scale;
+        FLOAT *twiddles_unalign;
+        FLOAT *twiddles_re;
+        FLOAT *twiddles_im;
+        FLOAT *work_unalign;
+        FLOAT *work_re;
+        FLOAT *work_im;
+
+        bool isPowerOfTwo(uint n);
+        int getPowerOfTwo(uint n);
+
+    public:
+        FFTransformerPlanar();
+        FFTransformerPlanar(int fftLength, int direction, FFTNormalization normalization = FFT_NORMALIZE_NONE);
+        virtual ~FFTransformerPlanar();
+
+        bool FFTInit(int fftLength, int direction, FFTNormalization normalization = FFT_NORMALIZE_NONE);
+        bool FFTransform(FLOAT *re, FLOAT *im);
+        //out of place, in_re and in_im are left untouched
+        bool FFTransform(const FLOAT *in_re, const FLOAT *in_im, FLOAT *re, FLOAT *im);
+};
+
+#endif // FFTRANSFORMERPLANAR_H
@@ -0,0 +1,207 @@
+#include "FFTransformerRader.h"
+
+template <class FLOAT>
+bool FFTransformerRader<FLOAT>::isPrime(uint n)
+{
+    if (n < 2) return false;
+    for (uint d = 2; d * d <= n; d++)
+    {
+        if (n % d == 0) return false;
+    }
+    return true;
+}
+
+template <class FLOAT>
+uint FFTransformerRader<FLOAT>::powMod(uint a, uint e, uint n)
+{
+    unsigned long long r = 1, b = a % n;
+    for (; e > 0; e >>= 1)
+    {
+        if (e & 1) r = r * b % n;
+        b = b * b % n;
+    }
+    return (uint)r;
+}
+
+//smallest g whose powers g^((p-1)/f) differ from 1 for every prime factor f of p - 1
+template <class FLOAT>
+uint FFTransformerRader<FLOAT>::primitiveRoot(uint p)
+{
+    if (p == 2) return 1;
+    uint factors[32];
+    int cnt = 0;
+    uint n = p - 1;
+    for (uint d = 2; d * d <= n; d++)
+    {
+        if (n % d == 0)
+        {
+            factors[cnt++] = d;
+            while (n % d == 0) n /= d;
+        }
+    }
+    if (n > 1) factors[cnt++] = n;
+    for (uint g = 2; g < p; g++)
+    {
+        bool root = true;
+        for (int i = 0; i < cnt && root; i++)
+        {
+            root = powMod(g, (p - 1) / factors[i], p) != 1;
+        }
+        if (root) return g;
+    }
+    return 0;
+}
+
+template <class FLOAT>
+FFTransformerRader<FLOAT>::FFTransformerRader() : length(0), convLength(0), perm_in(0), perm_out(0), kernel_unalign(0), kernel(0), work_unalign(0), work(0)
+{
+    //do nothing
+}
+
+template <class FLOAT>
+FFTransformerRader<FLOAT>::FFTransformerRader(int fftLength, int direction, FFTNormalization normalization) : length(0), convLength(0), perm_in(0), perm_out(0), kernel_unalign(0), kernel(0), work_unalign(0), work(0)
+{
+    FFTInit(fftLength, direction, normalization);
+}
+
+template <class FLOAT>
+FFTransformerRader<FLOAT>::~FFTransformerRader()
+{
+    if (this->perm_in != 0)
+    {
+        delete[] perm_in;
+    }
+    if (this->perm_out != 0)
+    {
+        delete[] perm_out;
+    }
+    if (this->kernel_unalign != 0)
+    {
+        delete[] kernel_unalign;
+    }
+    if (this->work_unalign != 0)
+    {
+        delete[] work_unalign;
+    }
+}
+
+template <class FLOAT>
+bool FFTransformerRader<FLOAT>::FFTInit(int fftLength, int direction, FFTNormalization normalization)
+{
+    if (fftLength <= 0 || !isPrime(fftLength))
+        return false;
+    const int L = fftLength - 1;
+    //both convolution transforms run forward, the inverse one by conjugation
+    //otherwise the smallest 7-smooth multiple of 4 that fits the linear convolution,
+    //but never above the next power of two
+    int M = L;
+    if (!fft.FFTInit(M, 1))
+    {
+        int pow2 = 1;
+        while (pow2 < 2 * L - 1)
+        {
+            pow2 *= 2;
+        }
+        M = (2 * L - 1 + 3) & ~3;
+        while (M < pow2 && !fft.FFTInit(M, 1))
+        {
+            M += 4;
+        }
+        if (M >= pow2)
+        {
+            M = pow2;
+            fft.FFTInit(M, 1);
+        }
+    }
+    this->length = fftLength;
+    this->direction = direction > 0 ? 1 : 0;
+    //the twiddles take the sign of the direction, any positive value is forward
+    int sign = direction > 0 ? 1 : -1;
+    this->scale = FFTNormalizationScale(normalization, fftLength);
+    this->convLength = M;
+    this->perm_in        = new uint[L];
+    this->perm_out       = new uint[L];
+    this->kernel_unalign = new Complex<FLOAT>[M + 32 / sizeof(Complex<FLOAT>)];
+    this->work_unalign   = new Complex<FLOAT>[M + 32 / sizeof(Complex<FLOAT>)];
+    this->kernel = (Complex<FLOAT>*)(((size_t)kernel_unalign | 31) + 1);
+    this->work   = (Complex<FLOAT>*)(((size_t)work_unalign | 31) + 1);
+    //perm_out[q] = g^q, perm_in[r] = g^-r = g^(L - r)
+    uint g = primitiveRoot(fftLength);
+    unsigned long long gq = 1;
+    for (int q = 0; q < L; q++)
+    {
+        perm_out[q] = (uint)gq;
+        perm_in[q == 0 ? 0 : L - q] = (uint)gq;
+        gq = gq * g % fftLength;
+    }
+    //W^(g^k) wrapped around M for the padded linear convolution, with the 1/M of
+    //the inverse transform and the plan normalization folded in
+    double kernelScale = scale / (double)M;
+    for (int k = 0; k < M; k++)
+    {
+        kernel[k].re = 0;
+        kernel[k].im = 0;
+    }
+    for (int k = 0; k < L; k++)
+    {
+        double twAngle = -2 * M_PI * sign * perm_out[k] / fftLength;
+        kernel[k].re = cos(twAngle) * kernelScale;
+        kernel[k].im = sin(twAngle) * kernelScale;
+        if (M != L && k > 0)
+        {
+            kernel[M - L + k] = kernel[k];
+        }
+    }
+    fft.FFTransform(kernel);
+    return true;
+}
+
+template <class FLOAT>
+bool FFTransformerRader<FLOAT>::FFTransform(Complex<FLOAT>* data)
+{
+    return FFTransform(data, data);
+}
+
+template <class FLOAT>
+bool FFTransformerRader<FLOAT>::FFTransform(const Complex<FLOAT>* in, Complex<FLOAT>* data)
+{
+    if (length <= 0) return false;
+    const int L = length - 1;
+    const int M = convLength;
+    Complex<FLOAT> x0 = in[0];
+    for (int r = 0; r < L; r++)
+    {
+        work[r] = in[perm_in[r]];
+    }
+    for (int r = L; r < M; r++)
+    {
+        work[r].re = 0;
+        work[r].im = 0;
+    }
+    fft.FFTransform(work);
+    //the DC term of the permuted input is the sum of x[1..p-1]
+    data[0].re = (x0.re + work[0].re) * scale;
+    data[0].im = (x0.im + work[0].im) * scale;
+    x0.re *= scale;
+    x0.im *= scale;
+    //pointwise product, conjugated so that the forward transform computes the inverse one
+    for (int k = 0; k < M; k++)
+    {
+        FLOAT re = work[k].re * kernel[k].re - work[k].im * kernel[k].im;
+        FLOAT im = work[k].re * kernel[k].im + work[k].im * kernel[k].re;
+        work[k].re = re;
+        work[k].im = -im;
+    }
+    fft.FFTransform(work);
+    for (int q = 0; q < L; q++)
+    {
+        Complex<FLOAT> *out = &data[perm_out[q]];
+        out->re = x0.re + work[q].re;
+        out->im = x0.im - work[q].im;
+    }
+    return true;
+}
+
+template class FFTransformerRader<float>;
+template class FFTransformerRader<double>;
+//template class FFTransformerRader<long double>;
@@ -0,0 +1,50 @@
+#ifndef FFTRANSFORMERRADER_H
+#define FFTRANSFORMERRADER_H
+
+#include <cmath>
+#include "Complex.h"
+#include "FFTOptions.h"
+#include "FFTransformerMixed.h"
+
+typedef unsigned int uint;
+
+// Transform of prime length p through Rader's algorithm: with a primitive root g
+// modulo p the outputs X[g^q] - x[0] are the cyclic convolution of x[g^-r] with
+// W^(g^k), a convolution of length p - 1. It runs on the mixed radix engine
+// when p - 1 has no prime factor above 7, otherwise zero padded to the
+// smallest 7-smooth M >= 2(p - 1) - 1. The permutations and the spectrum of W^(g^k) are
+// prepared by FFTInit, a transform costs two forward FFTs of the convolution length.
+// The scratch buffer belongs to the plan: one plan must not be used by several
+// threads at the same time.
+template <class FLOAT>
+class FFTransformerRader
+{
+    private:
+        int length;
+        int direction;
+        FLOAT scale;
+        int convLength;
+        FFTransformerMixed<FLOAT> fft;
+        uint *perm_in;
+        uint *perm_out;
+        Complex<FLOAT> *kernel_unalign;
+        Complex<FLOAT> *kernel;
+        Complex<FLOAT> *work_unalign;
+        Complex<FLOAT> *work;
+
+        static bool isPrime(uint n);
+        static uint powMod(uint a, uint e, uint n);
+        static uint primitiveRoot(uint p);
+
+    public:
+        FFTransformerRader();
+        FFTransformerRader(int fftLength, int direction, FFTNormalization normalization = FFT_NORMALIZE_NONE);
+        virtual ~FFTransformerRader();
+
+        bool FFTInit(int fftLength, int direction, FFTNormalization normalization = FFT_NORMALIZE_NONE);
+        bool FFTransform(Complex<FLOAT> *data);
+        //out of place, in is left untouched. in == out runs in place
+        bool FFTransform(const Complex<FLOAT> *in, Complex<FLOAT> *out);
+};
+
+#endif // FFTRANSFORMERRADER_H
@@ -0,0 +1,90 @@
+#include "FFTransformerReal.h"
+#include "FFTDispatch.h"
+
+template <class FLOAT>
+bool FFTransformerReal<FLOAT>::isPowerOfTwo(uint n)
+{
+    return ((n - 1) & n) == 0;
+}
+
+template <class FLOAT>
+FFTransformerReal<FLOAT>::FFTransformerReal() : length(0), twiddles_unalign(0), twiddles(0)
+{
+    //do nothing
+}
+
+template <class FLOAT>
+FFTransformerReal<FLOAT>::FFTransformerReal(int fftLength, int direction, FFTNormalization normalization) : length(0), twiddles_unalign(0), twiddles(0)
+{
+    FFTInit(fftLength, direction, normalization);
+}
+
+template <class FLOAT>
+FFTransformerReal<FLOAT>::~FFTransformerReal()
+{
+    if (this->twiddles_unalign != 0)
+    {
+        delete[] twiddles_unalign;
+    }
+}
+
+template <class FLOAT>
+bool FFTransformerReal<FLOAT>::FFTInit(int fftLength, int direction, FFTNormalization normalization)
+{
+    if (fftLength < 2 || !isPowerOfTwo(fftLength))
+        return false;
+    int half = fftLength / 2;
+    if (!fft.FFTInit(half, direction > 0 ? 1 : -1))
+        return false;
+    this->length = fftLength;
+    this->direction = direction > 0 ? 1 : 0;
+    this->scale = FFTNormalizationScale(normalization, fftLength);
+    //W_N^k for 0 <= k <= N/4 in both directions, padded for the vector loads of the post pass
+    int twLength = half / 2 + 1;
+    this->twiddles_unalign = new Complex<FLOAT>[twLength + 64 / sizeof(Complex<FLOAT>)];
+    this->twiddles = (Complex<FLOAT>*)(((size_t)twiddles_unalign | 31) + 1);
+    for (int k = 0; k < twLength; k++)
+    {
+        double twAngle = -2 * M_PI * k / fftLength;
+        twiddles[k].re = cos(twAngle);
+        twiddles[k].im = sin(twAngle);
+    }
+    return true;
+}
+
+template <class FLOAT>
+bool FFTransformerReal<FLOAT>::FFTransform(FLOAT* data)
+{
+    return FFTransform(data, data);
+}
+
+template <class FLOAT>
+bool FFTransformerReal<FLOAT>::FFTransform(const FLOAT* in, FLOAT* data)
+{
+    if (length <= 0) return false;
+    const int half = length / 2;
+    const Complex<FLOAT> *x = (const Complex<FLOAT>*)in;
+    Complex<FLOAT> *z = (Complex<FLOAT>*)data;
+    if (direction == 0)
+    {
+        const FLOAT x0_re = x[0].re;
+        const FLOAT xh_re = x[half].re;
+        FFTKernels<FLOAT>().realPrePass(x, z, half, twiddles, scale);
+        z[0].re = (x0_re + xh_re) * scale;
+        z[0].im = (x0_re - xh_re) * scale;
+        return fft.FFTransform(z);
+    }
+    fft.FFTransform(x, z);
+    FFTKernels<FLOAT>().realPostPass(z, half, twiddles, scale);
+    const FLOAT z0_re = z[0].re;
+    const FLOAT z0_im = z[0].im;
+    z[0].re = (z0_re + z0_im) * scale;
+    z[0].im = 0;
+    z[half].re = (z0_re - z0_im) * scale;
+    z[half].im = 0;
+    return true;
+}
+
+template class FFTransformerReal<float>;
+template class FFTransformerReal<double>;
+//template class FFTransformerReal<long double>;
@@ -0,0 +1,45 @@
+#ifndef FFTRANSFORMERREAL_H
+#define FFTRANSFORMERREAL_H
+
+#include <cmath>
+#include "Complex.h"
+#include "FFTOptions.h"
+#include "FFTransformerRecursive.h"
+
+typedef unsigned int uint;
+
+// Transform of N real samples, N a power of two. The samples are packed into
+// N/2 complexes z[n] = x[2n] + i x[2n + 1], transformed by FFTransformerRecursive
+// and split into the N/2 + 1 non-redundant bins by one post pass.
+// FFTransform works in place on a buffer of N + 2 FLOATs: N real samples in,
+// N/2 + 1 interleaved {re, im} bins out, the imaginary parts of bins 0 and N/2 are 0.
+// An inverse plan (direction <= 0) takes the N/2 + 1 bins of a Hermitian spectrum
+// and returns N real samples, merged into a half length inverse transform by one
+// pre pass. Without a normalization mode the output is N times x, as for the complex inverse.
+// The out of place FFTransform reads N samples or N/2 + 1 bins from in and
+// writes N + 2 or N FLOATs to out. in, out and data need no alignment
+// beyond that of FLOAT.
+template <class FLOAT>
+class FFTransformerReal
+{
+    private:
+        int length;
+        int direction;
+        FLOAT scale;
+        FFTransformerRecursive<FLOAT> fft;
+        Complex<FLOAT> *twiddles_unalign;
+        Complex<FLOAT> *twiddles;
+
+        bool isPowerOfTwo(uint n);
+
+    public:
+        FFTransformerReal();
+        FFTransformerReal(int fftLength, int direction, FFTNormalization normalization = FFT_NORMALIZE_NONE);
+        virtual ~FFTransformerReal();
+
+        bool FFTInit(int fftLength, int direction, FFTNormalization normalization = FFT_NORMALIZE_NONE);
+        bool FFTransform(FLOAT *data);
+        bool FFTransform(const FLOAT *in, FLOAT *out);
+};
+
+#endif // FFTRANSFORMERREAL_H
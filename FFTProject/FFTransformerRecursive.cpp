@@ -1,4 +1,7 @@
+#include <omp.h>
 #include "FFTransformerRecursive.h"
+#include "FFTDispatch.h"
+#include "FFTBatch.h"
 
 template <class FLOAT>
 bool FFTransformerRecursive<FLOAT>::isPowerOfTwo(uint n)
@@ -29,6 +32,12 @@ uint FFTransformerRecursive<FLOAT>::bitReverseInt32(uint v)
 template <class FLOAT>
 void FFTransformerRecursive<FLOAT>::arrayShuffle(Complex<FLOAT>* data, int length)
 {
+    //blocked permutation once the table walk starts missing the caches
+    if (length >= FFTBitReverse<FLOAT>::MIN_LENGTH)
+    {
+        bitReverse.Shuffle(data);
+        return;
+    }
 	for (int i = 0; i < length; i++)
 	{
 		int rev_ind = shuffle_ind[i];
@@ -42,15 +51,17 @@ void FFTransformerRecursive<FLOAT>::arrayShuffle(Complex<FLOAT>* data, int lengt
 }
 
 template <class FLOAT>
-FFTransformerRecursive<FLOAT>::FFTransformerRecursive() : twiddles(0), shuffle_ind(0)
+FFTransformerRecursive<FLOAT>::FFTransformerRecursive() : twiddles_unalign(0), twiddles(0), shuffle_ind_unalign(0), shuffle_ind(0),
+    branchLength(MIN_FFT_BRANCH), parallelLength(PARALLEL_LENGTH)
 {
     //do nothing
 }
 
 template <class FLOAT>
-FFTransformerRecursive<FLOAT>::FFTransformerRecursive(int fftLength, int direction) : twiddles(0)
+FFTransformerRecursive<FLOAT>::FFTransformerRecursive(int fftLength, int direction, FFTNormalization normalization) : twiddles_unalign(0), twiddles(0), shuffle_ind_unalign(0), shuffle_ind(0),
+    branchLength(MIN_FFT_BRANCH), parallelLength(PARALLEL_LENGTH)
 {
-    FFTInit(fftLength, direction);
+    FFTInit(fftLength, direction, normalization);
 }
 
 template <class FLOAT>
@@ -67,21 +78,25 @@ FFTransformerRecursive<FLOAT>::~FFTransformerRecursive()
 }
 
 template <class FLOAT>
-bool FFTransformerRecursive<FLOAT>::FFTInit(int fftLength, int direction)
+bool FFTransformerRecursive<FLOAT>::FFTInit(int fftLength, int direction, FFTNormalization normalization)
 {
     if (fftLength > 0 && isPowerOfTwo(fftLength))
     {
         this->length = fftLength;
         this->direction = direction > 0 ? 1 : 0;
-        this->twiddles_unalign    = new Complex<FLOAT>[fftLength + 16 / sizeof(Complex<FLOAT>)];
-        this->shuffle_ind_unalign = new uint[fftLength + 16 / sizeof(uint)];
-        this->twiddles = (Complex<FLOAT>*)((int)twiddles_unalign & (~15));
-        this->shuffle_ind = (uint*)((int)shuffle_ind_unalign & (~15));
+        //the twiddles take the sign of the direction, any positive value is forward
+        int sign = direction > 0 ? 1 : -1;
+        this->scale = FFTNormalizationScale(normalization, fftLength);
+        //32 byte alignment for the 256-bit twiddle loads
+        this->twiddles_unalign    = new Complex<FLOAT>[fftLength + 32 / sizeof(Complex<FLOAT>)];
+        this->shuffle_ind_unalign = new uint[fftLength + 32 / sizeof(uint)];
+        this->twiddles = (Complex<FLOAT>*)(((size_t)twiddles_unalign | 31) + 1);
+        this->shuffle_ind = (uint*)(((size_t)shuffle_ind_unalign | 31) + 1);
         for (int twSteep = 4; twSteep < fftLength; twSteep *= 2)
         {
             for (int i = 0; i < twSteep; i++)
             {
-                FLOAT twAngle = -M_PI * direction * i / twSteep;
+                FLOAT twAngle = -M_PI * sign * i / twSteep;
                 twiddles[twSteep + i - 4].re = cos(twAngle);
                 twiddles[twSteep + i - 4].im = sin(twAngle);
             }
@@ -91,12 +106,23 @@ bool FFTransformerRecursive<FLOAT>::FFTInit(int fftLength, int direction)
         {
             shuffle_ind[i] = bitReverseInt32(i) >> bit_cnt;
         }
+        bitReverse.Init(length);
         return true;
     }
     else
         return false;
 }
 
+template <class FLOAT>
+bool FFTransformerRecursive<FLOAT>::FFTSetTuning(int branchLength, int parallelLength)
+{
+    if (branchLength < 8 || parallelLength < 16 || !isPowerOfTwo(branchLength) || !isPowerOfTwo(parallelLength))
+        return false;
+    this->branchLength = branchLength;
+    this->parallelLength = parallelLength;
+    return true;
+}
+
 template <class FLOAT>
 bool FFTransformerRecursive<FLOAT>::FFTransform(Complex<FLOAT>* data)
 {
@@ -105,239 +131,183 @@ bool FFTransformerRecursive<FLOAT>::FFTransform(Complex<FLOAT>* data)
 }
 
 template <class FLOAT>
-bool FFTransformerRecursive<FLOAT>::FFTransform(Complex<FLOAT>* data, int length)
+bool FFTransformerRecursive<FLOAT>::FFTransform(const Complex<FLOAT>* in, Complex<FLOAT>* out)
 {
-    if (length <= MIN_FFT_BRANCH)
+    if (in == out)
     {
-        return FFTransformNormal(data, length);
+        return FFTransform(out);
     }
-    int steep = length / 2;
-    if (length >= 65536)
+    //short transforms gather the bit reversal into the leaves, long ones take
+    //the blocked shuffle instead of the cache missing gather
+    if (length >= FFTBitReverse<FLOAT>::MIN_LENGTH)
     {
-        #pragma omp parallel sections
-        {
-             #pragma omp section
-            {
-                FFTransform(data, steep);
-            }
-            #pragma omp section
-            {
-                FFTransform(data + steep, steep);
-            }
-        }
+        bitReverse.Shuffle(in, out);
+        return FFTransform(out, length);
     }
-    else
+    return FFTransform(out, length, in, shuffle_ind);
+}
+
+template <class FLOAT>
+bool FFTransformerRecursive<FLOAT>::FFTransform(const Complex<FLOAT>* in, Complex<FLOAT>* out, int stride)
+{
+    if (stride < 1) return false;
+    if (stride == 1)
     {
-        {
-            FFTransform(data, steep);
-        }
-        {
-            FFTransform(data + steep, steep);
-        }
+        return FFTransform(in, out);
     }
+    if (length >= FFTBitReverse<FLOAT>::MIN_LENGTH)
     {
-        for (int butterfly = 0; butterfly < steep; butterfly += 4)
-        {
-            Vec4f sign_1 = reinterpret_f(Vec4i(1<<31, 0, 1<<31, 0));
-            float *tw = (float*)&twiddles[steep + butterfly - 4];
-            Vec4f tw_norm_1, tw_perm_1, tw_norm_2, tw_perm_2;
-            tw_norm_1.load_a(tw);
-            tw_perm_1 = permute4f<1,1,3,3>(tw_norm_1) ^ sign_1;
-            tw_norm_1 = permute4f<0,0,2,2>(tw_norm_1);
-
-            tw_norm_2.load_a(tw + 4);
-            tw_perm_2 = permute4f<1,1,3,3>(tw_norm_2) ^ sign_1;
-            tw_norm_2 = permute4f<0,0,2,2>(tw_norm_2);
-
-            Complex<FLOAT> &a = data[butterfly];
-            Complex<FLOAT> &b = data[butterfly + steep];
-            Complex<FLOAT> &e = data[butterfly + 2];
-            Complex<FLOAT> &g = data[butterfly + 2 + steep];
-
-            Vec4f ac, bd, ef, gh;
-            ac.load_a((float*)&a);
-            bd.load_a((float*)&b);
-            ef.load_a((float*)&e);
-            gh.load_a((float*)&g);
-
-            Vec4f bd_perm = permute4f<1,0,3,2>(bd);
-            Vec4f uv_bd = bd * tw_norm_1 + bd_perm * tw_perm_1;
-            bd = ac - uv_bd;
-            ac = ac + uv_bd;
-
-            Vec4f gh_perm = permute4f<1,0,3,2>(gh);
-            Vec4f uv_gh = gh * tw_norm_2 + gh_perm * tw_perm_2;
-            gh = ef - uv_gh;
-            ef = ef + uv_gh;
+        //strided input is read in order, then shuffled in place
+        FFTBatchGather(in, stride, out, length);
+        return FFTransform(out);
+    }
+    return FFTransform(out, length, in, shuffle_ind, stride);
+}
 
-            ac.store_a((float*)&a);
-            bd.store_a((float*)&b);
-            ef.store_a((float*)&e);
-            gh.store_a((float*)&g);
+template <class FLOAT>
+bool FFTransformerRecursive<FLOAT>::FFTransform(Complex<FLOAT>* data, int length, const Complex<FLOAT>* src, const uint* perm, int stride)
+{
+    if (length <= branchLength)
+    {
+        return FFTransformNormal(data, length, src, perm, stride);
+    }
+    if (length >= parallelLength && !omp_in_parallel())
+    {
+        //one team for the whole recursion, the halves are tasks picked up by idle threads
+        #pragma omp parallel
+        {
+            #pragma omp single nowait
+            FFTransformTask(data, length, src, perm, stride);
         }
+        return true;
     }
+    const uint *perm_high = (perm != 0) ? perm + length / 2 : 0;
+    int steep = length / 2;
+    FFTransform(data, steep, src, perm, stride);
+    FFTransform(data + steep, steep, src, perm_high, stride);
+    FFTKernels<FLOAT>().twiddlePass(data, length, steep, twiddles);
     return true;
 }
 
 template <class FLOAT>
-bool FFTransformerRecursive<FLOAT>::FFTransformNormal(Complex<FLOAT>* data, int length)
+void FFTransformerRecursive<FLOAT>::FFTransformTask(Complex<FLOAT>* data, int length, const Complex<FLOAT>* src, const uint* perm, int stride)
 {
-    if (length <= 0 || !isPowerOfTwo(length)) return false;
-    if (length == 1) return true;
-	//arrayShuffle(data, length);
-	int stages = getPowerOfTwo(length);
-	//explicit first steep with singular twiddles
-	int steep = 8;
-	const FLOAT SQRT2_2 = 0.70710678118654752440084436210485;
-	for (int butterfly = 0; butterfly < length; butterfly += steep)
+    //below parallelLength the subtree runs serially on the thread that took the task
+    if (length < parallelLength)
     {
-        Complex<FLOAT> &a = data[butterfly + 0];
-        Complex<FLOAT> &c = data[butterfly + 2];
-        Complex<FLOAT> &e = data[butterfly + 4];
-        Complex<FLOAT> &g = data[butterfly + 6];
-
-        Vec4f ab, cd, ef, gh;
-        ab.load_a((float*)&a);
-        cd.load_a((float*)&c);
-        ef.load_a((float*)&e);
-        gh.load_a((float*)&g);
-        Vec4f sign_1 = reinterpret_f(Vec4i(0, 0, 1<<31, 1<<31));
-        Vec4f sign_2 = reinterpret_f(Vec4i(0, 0, 0,     1<<31));
-        Vec4f sign_3 = reinterpret_f(Vec4i(0, 0, 1<<31, 0));
-        Vec4f sqrt2_4f_1(0.5,  0.5,  SQRT2_2,  SQRT2_2);
-        Vec4f sqrt2_4f_2(-0.5, 0.5, -SQRT2_2, -SQRT2_2);
-        //Vec4f sqrt2_4f(SQRT2_2,-SQRT2_2,SQRT2_2,-SQRT2_2);
-
-        Vec4f ab_shuf = permute4f<2,3,0,1>(ab);
-        ab = (ab ^ sign_1) + ab_shuf;
-        Vec4f cd_shuf = permute4f<2,3,0,1>(cd) ;
-        cd = (cd ^ sign_1) + cd_shuf;
-        Vec4f ab_fin = ab + (permute4f<0,1,3,2>(cd) ^ sign_2);
-        Vec4f cd_fin = ab - (permute4f<0,1,3,2>(cd) ^ sign_2);
-
-        Vec4f ef_shuf = permute4f<2,3,0,1>(ef);
-        ef = (ef ^ sign_1) + ef_shuf;
-        Vec4f gh_shuf = permute4f<2,3,0,1>(gh) ;
-        gh = (gh ^ sign_1) + gh_shuf;
-        Vec4f ef_fin = ef + (permute4f<0,1,3,2>(gh) ^ sign_2);
-        Vec4f gh_fin = ef - (permute4f<0,1,3,2>(gh) ^ sign_2);
-
-
-        Vec4f ef_fin_shuf = permute4f<0,1,3,2>(ef_fin) ^ sign_2;
-        ef_shuf = (ef_fin + ef_fin_shuf) * sqrt2_4f_1;
-
-        Vec4f gh_fin_shuf = permute4f<0,1,3,2>(gh_fin) ^ sign_3;
-        gh_fin_shuf = (gh_fin + gh_fin_shuf) * sqrt2_4f_2;
-        gh_shuf = permute4f<1,0,2,3>(gh_fin_shuf);
-
-/*
-        Vec4f fh = blend4f<2,6,3,7>(ef_fin, gh_fin);
-        Vec4f fh_shuf = permute4f<2,3,0,1>(fh) ^ sign_4;
-        fh = (fh + fh_shuf) * sqrt2_4f;
-        ef_shuf = blend4f<0,1,4,6>(ef_fin, fh);
-        gh_shuf = blend4f<1,0,5,7>(gh_fin, fh) ^ sign_5;
-*/
-        ef_fin = ab_fin - ef_shuf;
-        ab_fin = ab_fin + ef_shuf;
-
-        gh_fin = cd_fin - gh_shuf;
-        cd_fin = cd_fin + gh_shuf;
-
-        ab_fin.store_a((float*)&a);
-        cd_fin.store_a((float*)&c);
-        ef_fin.store_a((float*)&e);
-        gh_fin.store_a((float*)&g);
-/*
-        FLOAT ua = a.re + b.re;
-        FLOAT va = a.im + b.im;
-        FLOAT ub = a.re - b.re;
-        FLOAT vb = a.im - b.im;
-
-        FLOAT uc = c.re + d.re;
-        FLOAT vc = c.im + d.im;
-        FLOAT ud = c.re - d.re;
-        FLOAT vd = c.im - d.im;
-
-        a.re = ua + uc;
-        a.im = va + vc;
-        b.re = ub + vd;
-        b.im = vb - ud;
+        FFTransform(data, length, src, perm, stride);
+        return;
+    }
+    const uint *perm_high = (perm != 0) ? perm + length / 2 : 0;
+    int steep = length / 2;
+    #pragma omp task
+    FFTransformTask(data, steep, src, perm, stride);
+    FFTransformTask(data + steep, steep, src, perm_high, stride);
+    #pragma omp taskwait
+    //the combine of the two halves is split into chunks as well, otherwise the top
+    //log2(length / parallelLength) stages would run on a single thread
+    const FFTKernelTable<FLOAT> &kernels = FFTKernels<FLOAT>();
+    for (int begin = 0; begin < steep; begin += COMBINE_CHUNK)
+    {
+        int end = (begin + COMBINE_CHUNK < steep) ? begin + COMBINE_CHUNK : steep;
+        #pragma omp task
+        kernels.twiddlePassRange(data, length, steep, twiddles, begin, end);
+    }
+    #pragma omp taskwait
+}
 
-        c.re = ua - uc;
-        c.im = va - vc;
-        d.re = ub - vd;
-        d.im = vb + ud;
-        */
+template <class FLOAT>
+bool FFTransformerRecursive<FLOAT>::FFTransformNormal(Complex<FLOAT>* data, int length, const Complex<FLOAT>* src, const uint* perm, int stride)
+{
+    if (length <= 0 || !isPowerOfTwo(length)) return false;
+    if (length == 1)
+    {
+        if (src != 0) data[0] = src[(size_t)perm[0] * stride];
+        return true;
     }
+	//arrayShuffle(data, length);
+	int stages = getPowerOfTwo(length);
+	const FFTKernelTable<FLOAT> &kernels = FFTKernels<FLOAT>();
+	//explicit first steep with singular twiddles. Every sample passes through
+	//exactly one leaf transform, so the normalization is folded in here
+	if (src != 0)
+        kernels.firstPassGather(src, data, length, perm, stride, direction, scale);
+    else
+        kernels.firstPass(data, length, direction, scale);
     if (length == 2) return true;
 
-	for (int stage = 3; stage < stages; stage++)
+	//remaining stages fused into radix-8 passes, one radix-4 or radix-2 pass for the rest
+	int stage = 3;
+	int twiddle_number = 8;
+	for (; stage + 3 <= stages; stage += 3, twiddle_number *= 8)
 	{
-		int twiddle_number = steep;
-		steep *= 2;
-        for (int twiddle = 0; twiddle < twiddle_number; twiddle+=4)
-        {
-            Vec4f sign_1 = reinterpret_f(Vec4i(1<<31, 0, 1<<31, 0));
-            float *tw = (float*)&twiddles[twiddle_number + twiddle - 4];
-            Vec4f tw_norm_1, tw_perm_1, tw_norm_2, tw_perm_2;
-            tw_norm_1.load_a(tw);
-            tw_perm_1 = permute4f<1,1,3,3>(tw_norm_1) ^ sign_1;
-            tw_norm_1 = permute4f<0,0,2,2>(tw_norm_1);
-            tw_norm_2.load_a(tw + 4);
-            tw_perm_2 = permute4f<1,1,3,3>(tw_norm_2) ^ sign_1;
-            tw_norm_2 = permute4f<0,0,2,2>(tw_norm_2);
+		kernels.twiddlePass8(data, length, twiddle_number, twiddles);
+	}
+	if (stages - stage == 2)
+	{
+		kernels.twiddlePass4(data, length, twiddle_number, twiddles);
+	}
+	else if (stages - stage == 1)
+	{
+		kernels.twiddlePass(data, length, twiddle_number, twiddles);
+	}
+	return true;
+}
 
-            for (int butterfly = twiddle; butterfly < length; butterfly += steep)
+template <class FLOAT>
+bool FFTransformerRecursive<FLOAT>::FFTransformBatch(Complex<FLOAT>* data, int howmany, int stride, int dist, bool parallel)
+{
+    if (length <= 0 || !isPowerOfTwo(length) || howmany < 0 || stride < 1) return false;
+    if (length == 1) return true;
+    if (dist == 0) dist = length * stride;
+    //the in place transforms run one level of OpenMP, inside the batch team they do not spawn tasks
+    #pragma omp parallel if (parallel)
+    {
+        Complex<FLOAT> *copy_unalign = 0;
+        Complex<FLOAT> *copy = 0;
+        if (stride != 1)
+        {
+            copy_unalign = new Complex<FLOAT>[length + 32 / sizeof(Complex<FLOAT>)];
+            copy = (Complex<FLOAT>*)(((size_t)copy_unalign | 31) + 1);
+        }
+        #pragma omp for schedule(static)
+        for (int i = 0; i < howmany; i++)
+        {
+            Complex<FLOAT> *x = data + (size_t)i * dist;
+            if (stride == 1)
             {
-                Complex<FLOAT> &a = data[butterfly];
-                Complex<FLOAT> &b = data[butterfly + twiddle_number];
-                Complex<FLOAT> &e = data[butterfly + 2];
-                Complex<FLOAT> &g = data[butterfly + 2 + twiddle_number];
-
-                Vec4f ac, bd, ef, gh;
-                ac.load_a((float*)&a);
-                bd.load_a((float*)&b);
-                ef.load_a((float*)&e);
-                gh.load_a((float*)&g);
-
-                Vec4f bd_perm = permute4f<1,0,3,2>(bd);
-                Vec4f uv_bd = bd * tw_norm_1 + bd_perm * tw_perm_1;
-                bd = ac - uv_bd;
-                ac = ac + uv_bd;
-
-                Vec4f gh_perm = permute4f<1,0,3,2>(gh);
-                Vec4f uv_gh = gh * tw_norm_2 + gh_perm * tw_perm_2;
-                gh = ef - uv_gh;
-                ef = ef + uv_gh;
-
-                ac.store_a((float*)&a);
-                bd.store_a((float*)&b);
-                ef.store_a((float*)&e);
-                gh.store_a((float*)&g);
-                /*
-                FLOAT ub = b.re * cb - b.im * sb;
-                FLOAT vb = b.re * sb + b.im * cb;
-
-                FLOAT ud = d.re * cd - d.im * sd;
-                FLOAT vd = d.re * sd + d.im * cd;
-
-                b.re = a.re - ub;
-                b.im = a.im - vb;
-                d.re = c.re - ud;
-                d.im = c.im - vd;
-
-                a.re = a.re + ub;
-                a.im = a.im + vb;
-                c.re = c.re + ud;
-                c.im = c.im + vd;
-                continue;
-                */
+                if (i + 1 < howmany) FFTBatchPrefetch(x + dist, length);
+                FFTransform(x);
+            }
+            else
+            {
+                //the gather is the first pass, only the scatter back is a separate copy
+                FFTransform(x, copy, stride);
+                FFTBatchScatter(copy, x, stride, length);
             }
         }
-	}
-	return true;
+        if (copy_unalign != 0)
+        {
+            delete[] copy_unalign;
+        }
+    }
+    return true;
+}
+
+template <class FLOAT>
+bool FFTransformerRecursive<FLOAT>::FFTransformBatch(const Complex<FLOAT>* in, Complex<FLOAT>* out, int howmany, int stride, int dist, bool parallel)
+{
+    if (length <= 0 || !isPowerOfTwo(length) || howmany < 0 || stride < 1) return false;
+    if (dist == 0) dist = length * stride;
+    //the transforms run one level of OpenMP, inside the batch team they do not spawn tasks
+    #pragma omp parallel for schedule(static) if (parallel)
+    for (int i = 0; i < howmany; i++)
+    {
+        FFTransform(in + (size_t)i * dist, out + (size_t)i * length, stride);
+    }
+    return true;
 }
 
 template class FFTransformerRecursive<float>;
-//template class FFTransformerRecursive<double>;
+template class FFTransformerRecursive<double>;
 //template class FFTransformerRecursive<long double>;
@@ -2,8 +2,9 @@
 #define FFTRANSFORMERRECURSIVE_H
 
 #include <cmath>
-#include "vectorclass.h"
 #include "Complex.h"
+#include "FFTOptions.h"
+#include "FFTBitReverse.h"
 
 typedef unsigned int uint;
 
@@ -14,27 +15,57 @@ class FFTransformerRecursive
     private:
         int length;
         int direction;
+        FLOAT scale;
         Complex<FLOAT> *twiddles_unalign;
         Complex<FLOAT> *twiddles;
         uint *shuffle_ind_unalign;
         uint *shuffle_ind;
+        FFTBitReverse<FLOAT> bitReverse;
+        //leaf length and task threshold in use, see FFTSetTuning
+        int branchLength;
+        int parallelLength;
 
         static const int MIN_FFT_BRANCH = 4096 * 1;
+        //subtrees from this length up become OpenMP tasks
+        static const int PARALLEL_LENGTH = 65536;
+        //butterflies per task of a parallel combine
+        static const int COMBINE_CHUNK = 16384;
 
         bool isPowerOfTwo(uint n);
         int getPowerOfTwo(uint n);
         uint bitReverseInt32(uint n);
         void arrayShuffle(Complex<FLOAT> *data, int length);
+        void FFTransformTask(Complex<FLOAT> *data, int length, const Complex<FLOAT> *src, const uint *perm, int stride);
 
     public:
         FFTransformerRecursive();
-        FFTransformerRecursive(int fftLength, int direction);
+        FFTransformerRecursive(int fftLength, int direction, FFTNormalization normalization = FFT_NORMALIZE_NONE);
         virtual ~FFTransformerRecursive();
 
-        bool FFTInit(int fftLength, int direction);
+        bool FFTInit(int fftLength, int direction, FFTNormalization normalization = FFT_NORMALIZE_NONE);
+        //subtrees up to branchLength points are leaves run by the radix-8 passes, from
+        //parallelLength points up they become OpenMP tasks. Powers of two, branchLength
+        //at least 8 and parallelLength at least 16. Defaults MIN_FFT_BRANCH and PARALLEL_LENGTH
+        bool FFTSetTuning(int branchLength, int parallelLength);
         bool FFTransform(Complex<FLOAT> *data);
-        bool FFTransform(Complex<FLOAT> *data, int length);
-        bool FFTransformNormal(Complex<FLOAT> *data, int length);
+        //out of place, in is left untouched. in == out runs in place.
+        //in and out need no alignment beyond that of Complex<FLOAT>
+        bool FFTransform(const Complex<FLOAT> *in, Complex<FLOAT> *out);
+        //howmany transforms, element j of transform i at data[i * dist + j * stride], see FFTBatch.h.
+        //parallel spreads the batch over the OpenMP threads. Any dist will do, the transforms
+        //need no alignment beyond that of Complex<FLOAT>
+        bool FFTransformBatch(Complex<FLOAT> *data, int howmany, int stride = 1, int dist = 0, bool parallel = false);
+        //strided input, out[j] is the transform of in[j * stride]. The gather is folded into the
+        //bit reversal of the leaves, from FFTBitReverse::MIN_LENGTH up the input is read in
+        //order into out and shuffled there. No scratch is needed, out must not overlap in
+        bool FFTransform(const Complex<FLOAT> *in, Complex<FLOAT> *out, int stride);
+        //guru style batch: element j of transform i is read from in[i * dist + j * stride] and
+        //written to out[i * length + j], dist 0 means length * stride. out must not overlap in,
+        //neither needs more than the alignment of Complex<FLOAT>
+        bool FFTransformBatch(const Complex<FLOAT> *in, Complex<FLOAT> *out, int howmany, int stride, int dist, bool parallel = false);
+        //src and perm given: the leaves read data[i] from src[perm[i] * stride], see FFTKernelTable::firstPassGather
+        bool FFTransform(Complex<FLOAT> *data, int length, const Complex<FLOAT> *src = 0, const uint *perm = 0, int stride = 1);
+        bool FFTransformNormal(Complex<FLOAT> *data, int length, const Complex<FLOAT> *src = 0, const uint *perm = 0, int stride = 1);
 };
 
 #endif // FFTRANSFORMERRECURSIVE_H
@@ -0,0 +1,217 @@
+#include "FFTransformerSplitRadix.h"
+
+template <class FLOAT>
+bool FFTransformerSplitRadix<FLOAT>::isPowerOfTwo(uint n)
+{
+    return ((n - 1) & n) == 0;
+}
+
+template <class FLOAT>
+int FFTransformerSplitRadix<FLOAT>::getPowerOfTwo(uint n)
+{
+    return 31 - __builtin_clz(n);
+}
+
+template <class FLOAT>
+uint FFTransformerSplitRadix<FLOAT>::bitReverseInt32(uint v)
+{
+    static const unsigned char rev_byte[256] = {0, 128, 64, 192, 32, 160, 96, 224, 16, 144, 80, 208, 48, 176, 112, 240, 8, 136, 72, 200, 40, 168, 104, 232, 24, 152, 88, 216, 56, 184, 120, 248, 4, 132, 68, 196, 36, 164, 100, 228, 20, 148, 84, 212, 52, 180, 116, 244, 12, 140, 76, 204, 44, 172, 108, 236, 28, 156, 92, 220, 60, 188, 124, 252, 2, 130, 66, 194, 34, 162, 98, 226, 18, 146, 82, 210, 50, 178, 114, 242, 10, 138, 74, 202, 42, 170, 106, 234, 26, 154, 90, 218, 58, 186, 122, 250, 6, 134, 70, 198, 38, 166, 102, 230, 22, 150, 86, 214, 54, 182, 118, 246, 14, 142, 78, 206, 46, 174, 110, 238, 30, 158, 94, 222, 62, 190, 126, 254, 1, 129, 65, 193, 33, 161, 97, 225, 17, 145, 81, 209, 49, 177, 113, 241, 9, 137, 73, 201, 41, 169, 105, 233, 25, 153, 89, 217, 57, 185, 121, 249, 5, 133, 69, 197, 37, 165, 101, 229, 21, 149, 85, 213, 53, 181, 117, 245, 13, 141, 77, 205, 45, 173, 109, 237, 29, 157, 93, 221, 61, 189, 125, 253, 3, 131, 67, 195, 35, 163, 99, 227, 19, 147, 83, 211, 51, 179, 115, 243, 11, 139, 75, 203, 43, 171, 107, 235, 27, 155, 91, 219, 59, 187, 123, 251, 7, 135, 71, 199, 39, 167, 103, 231, 23, 151, 87, 215, 55, 183, 119, 247, 15, 143, 79, 207, 47, 175, 111, 239, 31, 159, 95, 223, 63, 191, 127, 255, };
+	for (int i = 0; i < 4; i++)
+    {
+        uint t = v & 0xFF;
+        v = (v ^ t) | rev_byte[t];
+        v = (v >> 8) | (v << 24);
+    }
+	v = __builtin_bswap32(v);
+	return v;
+}
+
+template <class FLOAT>
+void FFTransformerSplitRadix<FLOAT>::arrayShuffle(Complex<FLOAT>* data, int length)
+{
+    //blocked permutation once the table walk starts missing the caches
+    if (length >= FFTBitReverse<FLOAT>::MIN_LENGTH)
+    {
+        bitReverse.Shuffle(data);
+        return;
+    }
+	for (int i = 0; i < length; i++)
+	{
+		int rev_ind = shuffle_ind[i];
+		if (rev_ind > i)
+        {
+            Complex<FLOAT> t = data[i];
+            data[i] = data[rev_ind];
+            data[rev_ind] = t;
+        }
+	}
+}
+
+//bit reversed copy, the permutation of an out of place transform
+template <class FLOAT>
+void FFTransformerSplitRadix<FLOAT>::arrayShuffle(const Complex<FLOAT>* in, Complex<FLOAT>* out, int length)
+{
+    if (length >= FFTBitReverse<FLOAT>::MIN_LENGTH)
+    {
+        bitReverse.Shuffle(in, out);
+        return;
+    }
+    for (int i = 0; i < length; i++)
+    {
+        out[i] = in[shuffle_ind[i]];
+    }
+}
+
+template <class FLOAT>
+FFTransformerSplitRadix<FLOAT>::FFTransformerSplitRadix() : twiddles(0), shuffle_ind(0)
+{
+    //do nothing
+}
+
+template <class FLOAT>
+FFTransformerSplitRadix<FLOAT>::FFTransformerSplitRadix(int fftLength, int direction, FFTNormalization normalization) : twiddles(0), shuffle_ind(0)
+{
+    FFTInit(fftLength, direction, normalization);
+}
+
+template <class FLOAT>
+FFTransformerSplitRadix<FLOAT>::~FFTransformerSplitRadix()
+{
+    if (this->twiddles != 0)
+    {
+        delete[] twiddles;
+    }
+    if (this->shuffle_ind != 0)
+    {
+        delete[] shuffle_ind;
+    }
+}
+
+template <class FLOAT>
+bool FFTransformerSplitRadix<FLOAT>::FFTInit(int fftLength, int direction, FFTNormalization normalization)
+{
+    if (fftLength > 0 && isPowerOfTwo(fftLength))
+    {
+        this->length = fftLength;
+        this->direction = direction > 0 ? 1 : 0;
+        //the twiddles take the sign of the direction, any positive value is forward
+        int sign = direction > 0 ? 1 : -1;
+        this->scale = FFTNormalizationScale(normalization, fftLength);
+        this->twiddles    = new Complex<FLOAT>[fftLength];
+        this->shuffle_ind = new uint[fftLength];
+        for (int twSteep = 1; twSteep < fftLength; twSteep *= 2)
+        {
+            for (int i = 0; i < twSteep; i++)
+            {
+                FLOAT twAngle = -M_PI * sign * i / twSteep;
+                twiddles[twSteep + i - 1].re = cos(twAngle);
+                twiddles[twSteep + i - 1].im = sin(twAngle);
+            }
+        }
+        int bit_cnt = 32 - getPowerOfTwo(length);
+        for (int i = 0; i < length; i++)
+        {
+            shuffle_ind[i] = bitReverseInt32(i) >> bit_cnt;
+        }
+        bitReverse.Init(length);
+        return true;
+    }
+    else
+        return false;
+}
+
+template <class FLOAT>
+void FFTransformerSplitRadix<FLOAT>::splitRadix(Complex<FLOAT>* data, int length)
+{
+    //every sample passes through exactly one leaf, the normalization is applied there
+    if (length == 1)
+    {
+        data[0].re *= scale;
+        data[0].im *= scale;
+        return;
+    }
+    if (length == 2)
+    {
+        Complex<FLOAT> &a = data[0];
+        Complex<FLOAT> &b = data[1];
+        FLOAT ur = a.re - b.re;
+        FLOAT ui = a.im - b.im;
+        a.re = (a.re + b.re) * scale;
+        a.im = (a.im + b.im) * scale;
+        b.re = ur * scale;
+        b.im = ui * scale;
+        return;
+    }
+    //sign of the quarter turn W^(N/4) = -i for the forward transform
+    FLOAT rot = direction ? 1 : -1;
+    int quarter = length / 4;
+    int half = length / 2;
+    splitRadix(data, half);
+    splitRadix(data + half, quarter);
+    splitRadix(data + half + quarter, quarter);
+    for (int k = 0; k < quarter; k++)
+    {
+        Complex<FLOAT> &u0 = data[k];
+        Complex<FLOAT> &u1 = data[k + quarter];
+        Complex<FLOAT> &z1 = data[k + half];
+        Complex<FLOAT> &z3 = data[k + half + quarter];
+
+        FLOAT c1 = twiddles[half + k - 1].re;
+        FLOAT s1 = twiddles[half + k - 1].im;
+        FLOAT c3, s3;
+        if (3 * k < half)
+        {
+            c3 = twiddles[half + 3 * k - 1].re;
+            s3 = twiddles[half + 3 * k - 1].im;
+        }
+        else
+        {
+            //W^(3k) = -W^(3k - N/2)
+            c3 = -twiddles[3 * k - 1].re;
+            s3 = -twiddles[3 * k - 1].im;
+        }
+
+        FLOAT ar = z1.re * c1 - z1.im * s1;
+        FLOAT ai = z1.re * s1 + z1.im * c1;
+        FLOAT br = z3.re * c3 - z3.im * s3;
+        FLOAT bi = z3.re * s3 + z3.im * c3;
+
+        FLOAT sr = ar + br;
+        FLOAT si = ai + bi;
+        //-i * rot * (a - b)
+        FLOAT dr =  rot * (ai - bi);
+        FLOAT di = -rot * (ar - br);
+
+        z1.re = u0.re - sr;
+        z1.im = u0.im - si;
+        u0.re = u0.re + sr;
+        u0.im = u0.im + si;
+
+        z3.re = u1.re - dr;
+        z3.im = u1.im - di;
+        u1.re = u1.re + dr;
+        u1.im = u1.im + di;
+    }
+}
+
+template <class FLOAT>
+bool FFTransformerSplitRadix<FLOAT>::FFTransform(Complex<FLOAT>* data)
+{
+    return FFTransform(data, data);
+}
+
+template <class FLOAT>
+bool FFTransformerSplitRadix<FLOAT>::FFTransform(const Complex<FLOAT>* in, Complex<FLOAT>* data)
+{
+    if (length <= 0 || !isPowerOfTwo(length)) return false;
+    if (in == data)
+        arrayShuffle(data, length);
+    else
+        arrayShuffle(in, data, length);
+    splitRadix(data, length);
+    return true;
+}
+
+template class FFTransformerSplitRadix<float>;
+template class FFTransformerSplitRadix<double>;
+template class FFTransformerSplitRadix<long double>;
@@ -0,0 +1,43 @@
+#ifndef FFTRANSFORMERSPLITRADIX_H
+#define FFTRANSFORMERSPLITRADIX_H
+
+#include <cmath>
+#include "Complex.h"
+#include "FFTOptions.h"
+#include "FFTBitReverse.h"
+
+typedef unsigned int uint;
+
+// Split-radix decimation in time: a length N transform is combined from one
+// N/2 transform of the even samples and two N/4 transforms of the samples
+// 4n+1 and 4n+3. Uses the twiddle table layout of FFTransformer.
+template <class FLOAT>
+class FFTransformerSplitRadix
+{
+    private:
+        int length;
+        int direction;
+        FLOAT scale;
+        Complex<FLOAT> *twiddles;
+        uint *shuffle_ind;
+        FFTBitReverse<FLOAT> bitReverse;
+
+        bool isPowerOfTwo(uint n);
+        int getPowerOfTwo(uint n);
+        uint bitReverseInt32(uint n);
+        void arrayShuffle(Complex<FLOAT> *data, int length);
+        void arrayShuffle(const Complex<FLOAT> *in, Complex<FLOAT> *out, int length);
+        void splitRadix(Complex<FLOAT> *data, int length);
+
+    public:
+        FFTransformerSplitRadix();
+        FFTransformerSplitRadix(int fftLength, int direction, FFTNormalization normalization = FFT_NORMALIZE_NONE);
+        virtual ~FFTransformerSplitRadix();
+
+        bool FFTInit(int fftLength, int direction, FFTNormalization normalization = FFT_NORMALIZE_NONE);
+        bool FFTransform(Complex<FLOAT> *data);
+        //out of place, in is left untouched. in == out runs in place
+        bool FFTransform(const Complex<FLOAT> *in, Complex<FLOAT> *out);
+};
+
+#endif // FFTRANSFORMERSPLITRADIX_H
@@ -0,0 +1,205 @@
+#include "FFTransformerStockham.h"
+#include "FFTDispatch.h"
+#include "FFTBatch.h"
+
+template <class FLOAT>
+bool FFTransformerStockham<FLOAT>::isPowerOfTwo(uint n)
+{
+    return ((n - 1) & n) == 0;
+}
+
+template <class FLOAT>
+int FFTransformerStockham<FLOAT>::getPowerOfTwo(uint n)
+{
+    return 31 - __builtin_clz(n);
+}
+
+template <class FLOAT>
+FFTransformerStockham<FLOAT>::FFTransformerStockham() : twiddles_unalign(0), twiddles(0), work_unalign(0), work(0)
+{
+    //do nothing
+}
+
+template <class FLOAT>
+FFTransformerStockham<FLOAT>::FFTransformerStockham(int fftLength, int direction, FFTNormalization normalization) : twiddles_unalign(0), twiddles(0), work_unalign(0), work(0)
+{
+    FFTInit(fftLength, direction, normalization);
+}
+
+template <class FLOAT>
+FFTransformerStockham<FLOAT>::~FFTransformerStockham()
+{
+    if (this->twiddles_unalign != 0)
+    {
+        delete[] twiddles_unalign;
+    }
+    if (this->work_unalign != 0)
+    {
+        delete[] work_unalign;
+    }
+}
+
+template <class FLOAT>
+bool FFTransformerStockham<FLOAT>::FFTInit(int fftLength, int direction, FFTNormalization normalization)
+{
+    if (fftLength > 0 && isPowerOfTwo(fftLength))
+    {
+        this->length = fftLength;
+        this->direction = direction > 0 ? 1 : 0;
+        //the twiddles take the sign of the direction, any positive value is forward
+        int sign = direction > 0 ? 1 : -1;
+        this->scale = FFTNormalizationScale(normalization, fftLength);
+        //the twiddles of all steps take 3/4 * (N + N/4 + ...) < N entries, plus one for a radix-2 step
+        this->twiddles_unalign = new Complex<FLOAT>[fftLength + 1 + 32 / sizeof(Complex<FLOAT>)];
+        this->work_unalign     = new Complex<FLOAT>[fftLength + 32 / sizeof(Complex<FLOAT>)];
+        this->twiddles = (Complex<FLOAT>*)(((size_t)twiddles_unalign | 31) + 1);
+        this->work     = (Complex<FLOAT>*)(((size_t)work_unalign | 31) + 1);
+        Complex<FLOAT> *tw = twiddles;
+        int n = fftLength;
+        for (; n >= 4; n /= 4)
+        {
+            int m = n / 4;
+            for (int k = 1; k <= 3; k++)
+            {
+                for (int p = 0; p < m; p++)
+                {
+                    FLOAT twAngle = -2 * M_PI * sign * k * p / n;
+                    tw[(k - 1) * m + p].re = cos(twAngle);
+                    tw[(k - 1) * m + p].im = sin(twAngle);
+                }
+            }
+            tw += 3 * m;
+        }
+        if (n == 2)
+        {
+            tw[0].re = 1;
+            tw[0].im = 0;
+        }
+        return true;
+    }
+    else
+        return false;
+}
+
+template <class FLOAT>
+bool FFTransformerStockham<FLOAT>::FFTransform(Complex<FLOAT>* data)
+{
+    return FFTransform(data, data);
+}
+
+template <class FLOAT>
+bool FFTransformerStockham<FLOAT>::FFTransform(const Complex<FLOAT>* in, Complex<FLOAT>* data)
+{
+    if (length <= 0 || !isPowerOfTwo(length)) return false;
+    if (length == 1)
+    {
+        data[0] = in[0];
+        return true;
+    }
+    transform(in, data, work, FFTKernels<FLOAT>());
+    return true;
+}
+
+template <class FLOAT>
+bool FFTransformerStockham<FLOAT>::FFTransform(const Complex<FLOAT>* in, Complex<FLOAT>* data, Complex<FLOAT>* scratch)
+{
+    if (length <= 0 || !isPowerOfTwo(length)) return false;
+    if (length == 1)
+    {
+        data[0] = in[0];
+        return true;
+    }
+    transform(in, data, scratch, FFTKernels<FLOAT>());
+    return true;
+}
+
+template <class FLOAT>
+void FFTransformerStockham<FLOAT>::transform(const Complex<FLOAT>* in, Complex<FLOAT>* data, Complex<FLOAT>* scratch, const FFTKernelTable<FLOAT> &kernels)
+{
+    int stages = getPowerOfTwo(length);
+    //out of place the first step reads in, and the ping-pong starts on the
+    //buffer that makes the last step land in data
+    const Complex<FLOAT> *src = in;
+    Complex<FLOAT> *dst = (in != data && (stages + 1) / 2 % 2 == 1) ? data : scratch;
+    const Complex<FLOAT> *tw = twiddles;
+    int n = length;
+    int s = 1;
+    for (; stages >= 2; stages -= 2)
+    {
+        //the last step has a single butterfly group and may write back in place,
+        //it also applies the normalization
+        FLOAT step_scale = 1;
+        if (n == 4)
+        {
+            dst = data;
+            if (stages == 2) step_scale = scale;
+        }
+        kernels.stockhamPass4(src, dst, n, s, tw, direction, step_scale);
+        tw += 3 * (n / 4);
+        n /= 4;
+        s *= 4;
+        src = dst;
+        dst = (dst == scratch) ? data : scratch;
+    }
+    if (stages == 1)
+    {
+        kernels.stockhamPass2(src, data, n, s, tw, scale);
+    }
+}
+
+template <class FLOAT>
+bool FFTransformerStockham<FLOAT>::FFTransformBatch(Complex<FLOAT>* data, int howmany, int stride, int dist, bool parallel)
+{
+    if (length <= 0 || !isPowerOfTwo(length) || howmany < 0 || stride < 1) return false;
+    if (length == 1) return true;
+    if (dist == 0) dist = length * stride;
+    //checks and kernel table lookup once for the whole batch
+    const FFTKernelTable<FLOAT> &kernels = FFTKernels<FLOAT>();
+    #pragma omp parallel if (parallel)
+    {
+        //the scratch buffer of the plan is shared, every thread of a parallel batch takes its own
+        Complex<FLOAT> *work_unalign_thread = 0;
+        Complex<FLOAT> *work_thread = work;
+        if (parallel)
+        {
+            work_unalign_thread = new Complex<FLOAT>[length + 32 / sizeof(Complex<FLOAT>)];
+            work_thread = (Complex<FLOAT>*)(((size_t)work_unalign_thread | 31) + 1);
+        }
+        Complex<FLOAT> *copy_unalign = 0;
+        Complex<FLOAT> *copy = 0;
+        if (stride != 1)
+        {
+            copy_unalign = new Complex<FLOAT>[length + 32 / sizeof(Complex<FLOAT>)];
+            copy = (Complex<FLOAT>*)(((size_t)copy_unalign | 31) + 1);
+        }
+        #pragma omp for schedule(static)
+        for (int i = 0; i < howmany; i++)
+        {
+            Complex<FLOAT> *x = data + (size_t)i * dist;
+            if (stride == 1)
+            {
+                if (i + 1 < howmany) FFTBatchPrefetch(x + dist, length);
+                transform(x, x, work_thread, kernels);
+            }
+            else
+            {
+                FFTBatchGather(x, stride, copy, length);
+                transform(copy, copy, work_thread, kernels);
+                FFTBatchScatter(copy, x, stride, length);
+            }
+        }
+        if (copy_unalign != 0)
+        {
+            delete[] copy_unalign;
+        }
+        if (work_unalign_thread != 0)
+        {
+            delete[] work_unalign_thread;
+        }
+    }
+    return true;
+}
+
+template class FFTransformerStockham<float>;
+template class FFTransformerStockham<double>;
+//template class FFTransformerStockham<long double>;
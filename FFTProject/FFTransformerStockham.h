@@ -0,0 +1,54 @@
+#ifndef FFTRANSFORMERSTOCKHAM_H
+#define FFTRANSFORMERSTOCKHAM_H
+
+#include <cmath>
+#include "Complex.h"
+#include "FFTOptions.h"
+
+typedef unsigned int uint;
+
+template <class FLOAT>
+struct FFTKernelTable;
+
+// Stockham autosort FFT: radix-4 steps (one radix-2 step for odd powers of two)
+// ping-pong between the data and a scratch buffer and leave the result in
+// natural order, so there is no bit reversal pass. The last step runs in place,
+// the output always ends up in data without a copy.
+// The scratch buffer belongs to the plan: one plan must not be used by several
+// threads at the same time. A parallel FFTransformBatch gives every thread its own.
+template <class FLOAT>
+class FFTransformerStockham
+{
+    private:
+        int length;
+        int direction;
+        FLOAT scale;
+        Complex<FLOAT> *twiddles_unalign;
+        Complex<FLOAT> *twiddles;
+        Complex<FLOAT> *work_unalign;
+        Complex<FLOAT> *work;
+
+        bool isPowerOfTwo(uint n);
+        int getPowerOfTwo(uint n);
+        void transform(const Complex<FLOAT> *in, Complex<FLOAT> *out, Complex<FLOAT> *scratch, const FFTKernelTable<FLOAT> &kernels);
+
+    public:
+        FFTransformerStockham();
+        FFTransformerStockham(int fftLength, int direction, FFTNormalization normalization = FFT_NORMALIZE_NONE);
+        virtual ~FFTransformerStockham();
+
+        bool FFTInit(int fftLength, int direction, FFTNormalization normalization = FFT_NORMALIZE_NONE);
+        bool FFTransform(Complex<FLOAT> *data);
+        //out of place, in is left untouched. in == out runs in place.
+        //in and out need no alignment beyond that of Complex<FLOAT>
+        bool FFTransform(const Complex<FLOAT> *in, Complex<FLOAT> *out);
+        //with a caller owned scratch buffer of length points, 32 byte aligned, in place of the
+        //one of the plan. Threads that bring their own scratch may share the plan
+        bool FFTransform(const Complex<FLOAT> *in, Complex<FLOAT> *out, Complex<FLOAT> *scratch);
+        //howmany transforms, element j of transform i at data[i * dist + j * stride], see FFTBatch.h.
+        //parallel spreads the batch over the OpenMP threads. Any dist will do, the transforms
+        //need no alignment beyond that of Complex<FLOAT>
+        bool FFTransformBatch(Complex<FLOAT> *data, int howmany, int stride = 1, int dist = 0, bool parallel = false);
+};
+
+#endif // FFTRANSFORMERSTOCKHAM_H
@@ -1,4 +1,6 @@
 #include "FFTransformerVec.h"
+#include "FFTDispatch.h"
+#include "FFTBatch.h"
 
 template <class FLOAT>
 bool FFTransformerVec<FLOAT>::isPowerOfTwo(uint n)
@@ -29,6 +31,12 @@ uint FFTransformerVec<FLOAT>::bitReverseInt32(uint v)
 template <class FLOAT>
 void FFTransformerVec<FLOAT>::arrayShuffle(Complex<FLOAT>* data, int length)
 {
+    //blocked permutation once the table walk starts missing the caches
+    if (length >= FFTBitReverse<FLOAT>::MIN_LENGTH)
+    {
+        bitReverse.Shuffle(data);
+        return;
+    }
 	for (int i = 0; i < length; i++)
 	{
 		int rev_ind = shuffle_ind[i];
@@ -42,15 +50,15 @@ void FFTransformerVec<FLOAT>::arrayShuffle(Complex<FLOAT>* data, int length)
 }
 
 template <class FLOAT>
-FFTransformerVec<FLOAT>::FFTransformerVec() : twiddles(0), shuffle_ind(0)
+FFTransformerVec<FLOAT>::FFTransformerVec() : twiddles_unalign(0), twiddles(0), shuffle_ind_unalign(0), shuffle_ind(0)
 {
     //do nothing
 }
 
 template <class FLOAT>
-FFTransformerVec<FLOAT>::FFTransformerVec(int fftLength, int direction) : twiddles(0)
+FFTransformerVec<FLOAT>::FFTransformerVec(int fftLength, int direction, FFTNormalization normalization) : twiddles_unalign(0), twiddles(0), shuffle_ind_unalign(0), shuffle_ind(0)
 {
-    FFTInit(fftLength, direction);
+    FFTInit(fftLength, direction, normalization);
 }
 
 template <class FLOAT>
@@ -67,21 +75,25 @@ FFTransformerVec<FLOAT>::~FFTransformerVec()
 }
 
 template <class FLOAT>
-bool FFTransformerVec<FLOAT>::FFTInit(int fftLength, int direction)
+bool FFTransformerVec<FLOAT>::FFTInit(int fftLength, int direction, FFTNormalization normalization)
 {
     if (fftLength > 0 && isPowerOfTwo(fftLength))
     {
         this->length = fftLength;
         this->direction = direction > 0 ? 1 : 0;
-        this->twiddles_unalign    = new Complex<FLOAT>[fftLength + 16 / sizeof(Complex<FLOAT>)];
-        this->shuffle_ind_unalign = new uint[fftLength + 16 / sizeof(uint)];
-        this->twiddles = (Complex<FLOAT>*)((int)twiddles_unalign & (~15));
-        this->shuffle_ind = (uint*)((int)shuffle_ind_unalign & (~15));
+        //the twiddles take the sign of the direction, any positive value is forward
+        int sign = direction > 0 ? 1 : -1;
+        this->scale = FFTNormalizationScale(normalization, fftLength);
+        //32 byte alignment for the 256-bit twiddle loads
+        this->twiddles_unalign    = new Complex<FLOAT>[fftLength + 32 / sizeof(Complex<FLOAT>)];
+        this->shuffle_ind_unalign = new uint[fftLength + 32 / sizeof(uint)];
+        this->twiddles = (Complex<FLOAT>*)(((size_t)twiddles_unalign | 31) + 1);
+        this->shuffle_ind = (uint*)(((size_t)shuffle_ind_unalign | 31) + 1);
         for (int twSteep = 4; twSteep < fftLength; twSteep *= 2)
         {
             for (int i = 0; i < twSteep; i++)
             {
-                FLOAT twAngle = -M_PI * direction * i / twSteep;
+                FLOAT twAngle = -M_PI * sign * i / twSteep;
                 twiddles[twSteep + i - 4].re = cos(twAngle);
                 twiddles[twSteep + i - 4].im = sin(twAngle);
             }
@@ -91,6 +103,7 @@ bool FFTransformerVec<FLOAT>::FFTInit(int fftLength, int direction)
         {
             shuffle_ind[i] = bitReverseInt32(i) >> bit_cnt;
         }
+        bitReverse.Init(length);
         return true;
     }
     else
@@ -99,163 +112,145 @@ bool FFTransformerVec<FLOAT>::FFTInit(int fftLength, int direction)
 
 template <class FLOAT>
 bool FFTransformerVec<FLOAT>::FFTransform(Complex<FLOAT>* data)
+{
+    return FFTransform(data, data);
+}
+
+template <class FLOAT>
+bool FFTransformerVec<FLOAT>::FFTransform(const Complex<FLOAT>* in, Complex<FLOAT>* data)
 {
     if (length <= 0 || !isPowerOfTwo(length)) return false;
-    if (length == 1) return true;
-	arrayShuffle(data, length);
-	int stages = getPowerOfTwo(length);
-	//explicit first steep with singular twiddles
-	int steep = 8;
-	const FLOAT SQRT2_2 = 0.70710678118654752440084436210485;
-	for (int butterfly = 0; butterfly < length; butterfly += steep)
+    if (length == 1)
     {
-        Complex<FLOAT> &a = data[butterfly + 0];
-        Complex<FLOAT> &c = data[butterfly + 2];
-        Complex<FLOAT> &e = data[butterfly + 4];
-        Complex<FLOAT> &g = data[butterfly + 6];
-
-        Vec4f ab, cd, ef, gh;
-        ab.load_a((float*)&a);
-        cd.load_a((float*)&c);
-        ef.load_a((float*)&e);
-        gh.load_a((float*)&g);
-        Vec4f sign_1 = reinterpret_f(Vec4i(0, 0, 1<<31, 1<<31));
-        Vec4f sign_2 = reinterpret_f(Vec4i(0, 0, 0,     1<<31));
-        Vec4f sign_3 = reinterpret_f(Vec4i(0, 0, 1<<31, 0));
-        Vec4f sqrt2_4f_1(0.5,  0.5,  SQRT2_2,  SQRT2_2);
-        Vec4f sqrt2_4f_2(-0.5, 0.5, -SQRT2_2, -SQRT2_2);
-        Vec4f sqrt2_4f(SQRT2_2,-SQRT2_2,SQRT2_2,-SQRT2_2);
-
-        Vec4f ab_shuf = permute4f<2,3,0,1>(ab);
-        ab = (ab ^ sign_1) + ab_shuf;
-        Vec4f cd_shuf = permute4f<2,3,0,1>(cd) ;
-        cd = (cd ^ sign_1) + cd_shuf;
-        Vec4f ab_fin = ab + (permute4f<0,1,3,2>(cd) ^ sign_2);
-        Vec4f cd_fin = ab - (permute4f<0,1,3,2>(cd) ^ sign_2);
-
-        Vec4f ef_shuf = permute4f<2,3,0,1>(ef);
-        ef = (ef ^ sign_1) + ef_shuf;
-        Vec4f gh_shuf = permute4f<2,3,0,1>(gh) ;
-        gh = (gh ^ sign_1) + gh_shuf;
-        Vec4f ef_fin = ef + (permute4f<0,1,3,2>(gh) ^ sign_2);
-        Vec4f gh_fin = ef - (permute4f<0,1,3,2>(gh) ^ sign_2);
-
-
-        Vec4f ef_fin_shuf = permute4f<0,1,3,2>(ef_fin) ^ sign_2;
-        ef_shuf = (ef_fin + ef_fin_shuf) * sqrt2_4f_1;
-
-        Vec4f gh_fin_shuf = permute4f<0,1,3,2>(gh_fin) ^ sign_3;
-        gh_fin_shuf = (gh_fin + gh_fin_shuf) * sqrt2_4f_2;
-        gh_shuf = permute4f<1,0,2,3>(gh_fin_shuf);
-
-/*
-        Vec4f fh = blend4f<2,6,3,7>(ef_fin, gh_fin);
-        Vec4f fh_shuf = permute4f<2,3,0,1>(fh) ^ sign_4;
-        fh = (fh + fh_shuf) * sqrt2_4f;
-        ef_shuf = blend4f<0,1,4,6>(ef_fin, fh);
-        gh_shuf = blend4f<1,0,5,7>(gh_fin, fh) ^ sign_5;
-*/
-        ef_fin = ab_fin - ef_shuf;
-        ab_fin = ab_fin + ef_shuf;
-
-        gh_fin = cd_fin - gh_shuf;
-        cd_fin = cd_fin + gh_shuf;
-
-        ab_fin.store_a((float*)&a);
-        cd_fin.store_a((float*)&c);
-        ef_fin.store_a((float*)&e);
-        gh_fin.store_a((float*)&g);
-/*
-        FLOAT ua = a.re + b.re;
-        FLOAT va = a.im + b.im;
-        FLOAT ub = a.re - b.re;
-        FLOAT vb = a.im - b.im;
-
-        FLOAT uc = c.re + d.re;
-        FLOAT vc = c.im + d.im;
-        FLOAT ud = c.re - d.re;
-        FLOAT vd = c.im - d.im;
+        data[0] = in[0];
+        return true;
+    }
+    transform(in, data, 1, FFTKernels<FLOAT>());
+    return true;
+}
 
-        a.re = ua + uc;
-        a.im = va + vc;
-        b.re = ub + vd;
-        b.im = vb - ud;
+template <class FLOAT>
+bool FFTransformerVec<FLOAT>::FFTransform(const Complex<FLOAT>* in, Complex<FLOAT>* data, int stride)
+{
+    if (length <= 0 || !isPowerOfTwo(length) || stride < 1) return false;
+    if (length == 1)
+    {
+        data[0] = in[0];
+        return true;
+    }
+    transform(in, data, stride, FFTKernels<FLOAT>());
+    return true;
+}
 
-        c.re = ua - uc;
-        c.im = va - vc;
-        d.re = ub - vd;
-        d.im = vb + ud;
-        */
+template <class FLOAT>
+void FFTransformerVec<FLOAT>::transform(const Complex<FLOAT>* in, Complex<FLOAT>* data, int stride, const FFTKernelTable<FLOAT> &kernels)
+{
+	int stages = getPowerOfTwo(length);
+	//explicit first steep with singular twiddles, normalization folded in.
+	//Out of place the first pass gathers its inputs and is the bit reversal,
+	//long transforms take the blocked shuffle instead of the cache missing gather
+	if (in == data)
+    {
+        arrayShuffle(data, length);
+        kernels.firstPass(data, length, direction, scale);
+    }
+    else if (length >= FFTBitReverse<FLOAT>::MIN_LENGTH)
+    {
+        if (stride == 1)
+        {
+            bitReverse.Shuffle(in, data);
+        }
+        else
+        {
+            //strided input is read in order, then shuffled in place
+            FFTBatchGather(in, stride, data, length);
+            bitReverse.Shuffle(data);
+        }
+        kernels.firstPass(data, length, direction, scale);
     }
-    if (length == 2) return true;
+    else
+    {
+        kernels.firstPassGather(in, data, length, shuffle_ind, stride, direction, scale);
+    }
+    if (length == 2) return;
 
-	for (int stage = 3; stage < stages; stage++)
+	//remaining stages fused into radix-8 passes, one radix-4 or radix-2 pass for the rest
+	int stage = 3;
+	int twiddle_number = 8;
+	for (; stage + 3 <= stages; stage += 3, twiddle_number *= 8)
 	{
-		int twiddle_number = steep;
-		steep *= 2;
-        for (int twiddle = 0; twiddle < twiddle_number; twiddle+=4)
-        {
-            Vec4f sign_1 = reinterpret_f(Vec4i(1<<31, 0, 1<<31, 0));
-            float *tw = (float*)&twiddles[twiddle_number + twiddle - 4];
-            Vec4f tw_norm_1, tw_perm_1, tw_norm_2, tw_perm_2;
-            tw_norm_1.load_a(tw);
-            tw_perm_1 = permute4f<1,1,3,3>(tw_norm_1) ^ sign_1;
-            tw_norm_1 = permute4f<0,0,2,2>(tw_norm_1);
-            tw_norm_2.load_a(tw + 4);
-            tw_perm_2 = permute4f<1,1,3,3>(tw_norm_2) ^ sign_1;
-            tw_norm_2 = permute4f<0,0,2,2>(tw_norm_2);
+		kernels.twiddlePass8(data, length, twiddle_number, twiddles);
+	}
+	if (stages - stage == 2)
+	{
+		kernels.twiddlePass4(data, length, twiddle_number, twiddles);
+	}
+	else if (stages - stage == 1)
+	{
+		kernels.twiddlePass(data, length, twiddle_number, twiddles);
+	}
+}
 
-            for (int butterfly = twiddle; butterfly < length; butterfly += steep)
+template <class FLOAT>
+bool FFTransformerVec<FLOAT>::FFTransformBatch(Complex<FLOAT>* data, int howmany, int stride, int dist, bool parallel)
+{
+    if (length <= 0 || !isPowerOfTwo(length) || howmany < 0 || stride < 1) return false;
+    if (length == 1) return true;
+    if (dist == 0) dist = length * stride;
+    //checks and kernel table lookup once for the whole batch
+    const FFTKernelTable<FLOAT> &kernels = FFTKernels<FLOAT>();
+    #pragma omp parallel if (parallel)
+    {
+        Complex<FLOAT> *copy_unalign = 0;
+        Complex<FLOAT> *copy = 0;
+        if (stride != 1)
+        {
+            copy_unalign = new Complex<FLOAT>[length + 32 / sizeof(Complex<FLOAT>)];
+            copy = (Complex<FLOAT>*)(((size_t)copy_unalign | 31) + 1);
+        }
+        #pragma omp for schedule(static)
+        for (int i = 0; i < howmany; i++)
+        {
+            Complex<FLOAT> *x = data + (size_t)i * dist;
+            if (stride == 1)
             {
-                Complex<FLOAT> &a = data[butterfly];
-                Complex<FLOAT> &b = data[butterfly + twiddle_number];
-                Complex<FLOAT> &e = data[butterfly + 2];
-                Complex<FLOAT> &g = data[butterfly + 2 + twiddle_number];
-
-                Vec4f ac, bd, ef, gh;
-                ac.load_a((float*)&a);
-                bd.load_a((float*)&b);
-                ef.load_a((float*)&e);
-                gh.load_a((float*)&g);
-
-                Vec4f bd_perm = permute4f<1,0,3,2>(bd);
-                Vec4f uv_bd = bd * tw_norm_1 + bd_perm * tw_perm_1;
-                bd = ac - uv_bd;
-                ac = ac + uv_bd;
-
-                Vec4f gh_perm = permute4f<1,0,3,2>(gh);
-                Vec4f uv_gh = gh * tw_norm_2 + gh_perm * tw_perm_2;
-                gh = ef - uv_gh;
-                ef = ef + uv_gh;
-
-                ac.store_a((float*)&a);
-                bd.store_a((float*)&b);
-                ef.store_a((float*)&e);
-                gh.store_a((float*)&g);
-                /*
-                FLOAT ub = b.re * cb - b.im * sb;
-                FLOAT vb = b.re * sb + b.im * cb;
-
-                FLOAT ud = d.re * cd - d.im * sd;
-                FLOAT vd = d.re * sd + d.im * cd;
-
-                b.re = a.re - ub;
-                b.im = a.im - vb;
-                d.re = c.re - ud;
-                d.im = c.im - vd;
-
-                a.re = a.re + ub;
-                a.im = a.im + vb;
-                c.re = c.re + ud;
-                c.im = c.im + vd;
-                continue;
-                */
+                if (i + 1 < howmany) FFTBatchPrefetch(x + dist, length);
+                transform(x, x, 1, kernels);
+            }
+            else
+            {
+                //the gather is the first pass, only the scatter back is a separate copy
+                transform(x, copy, stride, kernels);
+                FFTBatchScatter(copy, x, stride, length);
             }
         }
-	}
-	return true;
+        if (copy_unalign != 0)
+        {
+            delete[] copy_unalign;
+        }
+    }
+    return true;
+}
+
+template <class FLOAT>
+bool FFTransformerVec<FLOAT>::FFTransformBatch(const Complex<FLOAT>* in, Complex<FLOAT>* out, int howmany, int stride, int dist, bool parallel)
+{
+    if (length <= 0 || !isPowerOfTwo(length) || howmany < 0 || stride < 1) return false;
+    if (dist == 0) dist = length * stride;
+    const FFTKernelTable<FLOAT> &kernels = FFTKernels<FLOAT>();
+    #pragma omp parallel for schedule(static) if (parallel)
+    for (int i = 0; i < howmany; i++)
+    {
+        const Complex<FLOAT> *x = in + (size_t)i * dist;
+        Complex<FLOAT> *y = out + (size_t)i * length;
+        if (length == 1)
+            y[0] = x[0];
+        else
+            transform(x, y, stride, kernels);
+    }
+    return true;
 }
 
 template class FFTransformerVec<float>;
-//template class FFTransformerVec<double>;
+template class FFTransformerVec<double>;
 //template class FFTransformerVec<long double>;
@@ -2,11 +2,15 @@
 #define FFTRANSFORMERVEC_H
 
 #include <cmath>
-#include "vectorclass.h"
 #include "Complex.h"
+#include "FFTOptions.h"
+#include "FFTBitReverse.h"
 
 typedef unsigned int uint;
 
+template <class FLOAT>
+struct FFTKernelTable;
+
 
 template <class FLOAT>
 class FFTransformerVec
@@ -14,23 +18,41 @@ class FFTransformerVec
     private:
         int length;
         int direction;
+        FLOAT scale;
         Complex<FLOAT> *twiddles_unalign;
         Complex<FLOAT> *twiddles;
         uint *shuffle_ind_unalign;
         uint *shuffle_ind;
+        FFTBitReverse<FLOAT> bitReverse;
 
         bool isPowerOfTwo(uint n);
         int getPowerOfTwo(uint n);
         uint bitReverseInt32(uint n);
         void arrayShuffle(Complex<FLOAT> *data, int length);
+        void transform(const Complex<FLOAT> *in, Complex<FLOAT> *out, int stride, const FFTKernelTable<FLOAT> &kernels);
 
     public:
         FFTransformerVec();
-        FFTransformerVec(int fftLength, int direction);
+        FFTransformerVec(int fftLength, int direction, FFTNormalization normalization = FFT_NORMALIZE_NONE);
         virtual ~FFTransformerVec();
 
-        bool FFTInit(int fftLength, int direction);
+        bool FFTInit(int fftLength, int direction, FFTNormalization normalization = FFT_NORMALIZE_NONE);
         bool FFTransform(Complex<FLOAT> *data);
+        //out of place, in is left untouched. in == out runs in place.
+        //in and out need no alignment beyond that of Complex<FLOAT>
+        bool FFTransform(const Complex<FLOAT> *in, Complex<FLOAT> *out);
+        //howmany transforms, element j of transform i at data[i * dist + j * stride], see FFTBatch.h.
+        //parallel spreads the batch over the OpenMP threads. Any dist will do, the transforms
+        //need no alignment beyond that of Complex<FLOAT>
+        bool FFTransformBatch(Complex<FLOAT> *data, int howmany, int stride = 1, int dist = 0, bool parallel = false);
+        //strided input, out[j] is the transform of in[j * stride]. The gather is folded into the
+        //bit reversal of the first pass, from FFTBitReverse::MIN_LENGTH up the input is read in
+        //order into out and shuffled there. No scratch is needed, out must not overlap in
+        bool FFTransform(const Complex<FLOAT> *in, Complex<FLOAT> *out, int stride);
+        //guru style batch: element j of transform i is read from in[i * dist + j * stride] and
+        //written to out[i * length + j], dist 0 means length * stride. out must not overlap in,
+        //neither needs more than the alignment of Complex<FLOAT>
+        bool FFTransformBatch(const Complex<FLOAT> *in, Complex<FLOAT> *out, int howmany, int stride, int dist, bool parallel = false);
 };
 
 #endif // FFTRANSFORMER_H
@@ -6,6 +6,19 @@
 #include <Complex.h>
 #include <FFTransformerVec.h>
 #include <FFTransformerRecursive.h>
+#include <FFTransformerBluestein.h>
+#include <FFTransformerMixed.h>
+#include <FFTransformerRader.h>
+#include <FFTransformerReal.h>
+#include <FFTransformerPlanar.h>
+#include <FFTransformerLanes.h>
+#include <FFTransformerFourStep.h>
+#include <FFTransformer2D.h>
+#include <FFTransformer3D.h>
+#include <FFTransformerAuto.h>
+#include <FFTransformerStockham.h>
+#include <FFTDispatch.h>
+#include <FFTBitReverse.h>
 #include "fftw/fftw3.h"
 
 using namespace std;
@@ -49,9 +62,9 @@ void compareFFTW3()
         data[i].re = 100*(float)rand() / RAND_MAX;
         data[i].im = 100*(float)rand() / RAND_MAX;
     }
-    //FFTransformerVec<float> FFT(N, 1);
-    FFTransformerRecursive<float> FFT(N, 1);
+    FFTransformerAuto<float> FFT(N, FFT_FORWARD);
     FFT.FFTransform(data);
+    cout << "Planner picked the " << FFTEngineName(FFT.FFTGetChoice().engine) << " engine" << endl;
 
     float acc = 0;
     for (int i = 0; i < N; i++)
@@ -69,6 +82,552 @@ void compareFFTW3()
     fftwf_free(out);
 }
 
+void compareBluestein()
+{
+    static const int fftSizes[] = {1000, 44100};
+    for (int szInd = 0; szInd < 2; szInd++)
+    {
+        const int N = fftSizes[szInd];
+        fftwf_complex *in  = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex) * N);
+        fftwf_complex *out = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex) * N);
+        Complex<float> *data = new Complex<float>[N];
+        for (int i = 0; i < N; i++)
+        {
+            data[i].re = in[i][0] = 100*(float)rand() / RAND_MAX;
+            data[i].im = in[i][1] = 100*(float)rand() / RAND_MAX;
+        }
+        fftwf_plan p = fftwf_plan_dft_1d(N, in, out, FFTW_FORWARD, FFTW_ESTIMATE);
+        fftwf_execute(p);
+        FFTransformerBluestein<float> FFT(N, 1);
+        FFT.FFTransform(data);
+
+        float acc = 0;
+        for (int i = 0; i < N; i++)
+        {
+            acc += (out[i][0] - data[i].re)*(out[i][0] - data[i].re) +
+                   (out[i][1] - data[i].im)*(out[i][1] - data[i].im);
+        }
+        acc /= N;
+        cout << "Size " << N << ": mean square error " << acc << endl;
+
+        fftwf_destroy_plan(p);
+        fftwf_free(in);
+        fftwf_free(out);
+        delete[] data;
+    }
+}
+
+void testMixedRadix()
+{
+    static const int fftSizes[] = {480, 512, 960, 1024, 1920, 2048, 3072, 4096};
+    static const int maxMemoryLimit = 1048576;
+    Complex<float> *data = prepareData<float>(maxMemoryLimit);
+    for (int szInd = 0; szInd < 8; szInd++)
+    {
+        int fftSize = fftSizes[szInd];
+        int fftNumber = maxMemoryLimit / fftSize;
+        FFTransformerMixed<float> FFT(fftSize, 1);
+        FFTransformerBluestein<float> FFTBluestein(fftSize, 1);
+        double tStart = omp_get_wtime();
+        for (int i = 0; i < fftNumber; i++)
+        {
+            FFT.FFTransform(&data[i * fftSize]);
+        }
+        double tEnd = omp_get_wtime();
+        cout << "Size " << fftSize << ": mixed radix took " << 1e6*(tEnd - tStart)/fftNumber << " us, ";
+        tStart = omp_get_wtime();
+        for (int i = 0; i < fftNumber; i++)
+        {
+            FFTBluestein.FFTransform(&data[i * fftSize]);
+        }
+        tEnd = omp_get_wtime();
+        cout << "Bluestein took " << 1e6*(tEnd - tStart)/fftNumber << " us" << endl;
+    }
+    delete[] data;
+}
+
+void testPrimeLengths()
+{
+    static const int fftSizes[] = {1009, 4099, 40961, 65537};
+    static const int maxMemoryLimit = 1048576;
+    Complex<float> *data = prepareData<float>(maxMemoryLimit);
+    for (int szInd = 0; szInd < 4; szInd++)
+    {
+        int fftSize = fftSizes[szInd];
+        int fftNumber = maxMemoryLimit / fftSize;
+        FFTransformerRader<float> FFT(fftSize, 1);
+        FFTransformerBluestein<float> FFTBluestein(fftSize, 1);
+        double tStart = omp_get_wtime();
+        for (int i = 0; i < fftNumber; i++)
+        {
+            FFT.FFTransform(&data[i * fftSize]);
+        }
+        double tEnd = omp_get_wtime();
+        cout << "Size " << fftSize << ": Rader took " << 1e6*(tEnd - tStart)/fftNumber << " us, ";
+        tStart = omp_get_wtime();
+        for (int i = 0; i < fftNumber; i++)
+        {
+            FFTBluestein.FFTransform(&data[i * fftSize]);
+        }
+        tEnd = omp_get_wtime();
+        cout << "Bluestein took " << 1e6*(tEnd - tStart)/fftNumber << " us" << endl;
+    }
+    delete[] data;
+}
+
+void testRealInput()
+{
+    static const int fftSizes[] = {4096, 65536, 1048576};
+    static const int maxMemoryLimit = 4194304;
+    float *data = new float[maxMemoryLimit + 2];
+    Complex<float> *dataComplex = new Complex<float>[maxMemoryLimit];
+    for (int szInd = 0; szInd < 3; szInd++)
+    {
+        int fftSize = fftSizes[szInd];
+        int fftNumber = maxMemoryLimit / fftSize;
+        FFTransformerReal<float> FFT(fftSize, 1);
+        FFTransformerReal<float> IFFT(fftSize, -1);
+        FFTransformerRecursive<float> FFTComplex(fftSize, 1);
+        double tReal = 0, tComplex = 0, tInverse = 0;
+        for (int i = 0; i < fftNumber; i++)
+        {
+            for (int j = 0; j < fftSize; j++)
+            {
+                data[j] = dataComplex[j].re = static_cast<float>(rand()) / RAND_MAX;
+                dataComplex[j].im = 0;
+            }
+            double tStart = omp_get_wtime();
+            FFT.FFTransform(data);
+            double tEnd = omp_get_wtime();
+            FFTComplex.FFTransform(dataComplex);
+            tReal += tEnd - tStart;
+            tComplex += omp_get_wtime() - tEnd;
+            tStart = omp_get_wtime();
+            IFFT.FFTransform(data);
+            tInverse += omp_get_wtime() - tStart;
+        }
+        cout << "Size " << fftSize << ": real input took " << 1e6*tReal/fftNumber << " us, ";
+        cout << "real inverse took " << 1e6*tInverse/fftNumber << " us, ";
+        cout << "complex transform took " << 1e6*tComplex/fftNumber << " us" << endl;
+    }
+    delete[] data;
+    delete[] dataComplex;
+}
+
+void testNormalization()
+{
+    static const int fftSizes[] = {1024, 65536, 1048576};
+    static const int maxMemoryLimit = 4194304;
+    Complex<float> *data = prepareData<float>(maxMemoryLimit);
+    Complex<float> *orig = new Complex<float>[maxMemoryLimit];
+    memcpy(orig, data, maxMemoryLimit * sizeof(Complex<float>));
+    for (int szInd = 0; szInd < 3; szInd++)
+    {
+        int fftSize = fftSizes[szInd];
+        int fftNumber = maxMemoryLimit / fftSize;
+        FFTransformerRecursive<float> FFT(fftSize, FFT_FORWARD);
+        FFTransformerRecursive<float> IFFT(fftSize, FFT_INVERSE);
+        FFTransformerRecursive<float> IFFTNorm(fftSize, FFT_INVERSE, FFT_NORMALIZE_N);
+        double tLoop = 0, tFused = 0, maxError = 0;
+        for (int i = 0; i < fftNumber; i++)
+        {
+            Complex<float> *d = data + i * fftSize;
+            FFT.FFTransform(d);
+            double tStart = omp_get_wtime();
+            IFFT.FFTransform(d);
+            float rLength = 1.0f / fftSize;
+            for (int j = 0; j < fftSize; j++)
+            {
+                d[j].re *= rLength;
+                d[j].im *= rLength;
+            }
+            double tEnd = omp_get_wtime();
+            FFT.FFTransform(d);
+            double tFusedStart = omp_get_wtime();
+            IFFTNorm.FFTransform(d);
+            tFused += omp_get_wtime() - tFusedStart;
+            tLoop += tEnd - tStart;
+            for (int j = 0; j < fftSize; j++)
+            {
+                double diff = max(fabs(d[j].re - orig[i * fftSize + j].re), fabs(d[j].im - orig[i * fftSize + j].im));
+                if (diff > maxError) maxError = diff;
+            }
+        }
+        cout << "Size " << fftSize << ": inverse with 1/N loop took " << 1e6*tLoop/fftNumber << " us, ";
+        cout << "fused 1/N took " << 1e6*tFused/fftNumber << " us, round trip max error " << maxError << endl;
+    }
+    delete[] data;
+    delete[] orig;
+}
+
+void testPlanar()
+{
+    static const int fftSizes[] = {1024, 65536, 1048576};
+    static const int maxMemoryLimit = 4194304;
+    float *re = new float[maxMemoryLimit];
+    float *im = new float[maxMemoryLimit];
+    Complex<float> *data = new Complex<float>[maxMemoryLimit];
+    for (int szInd = 0; szInd < 3; szInd++)
+    {
+        int fftSize = fftSizes[szInd];
+        int fftNumber = maxMemoryLimit / fftSize;
+        FFTransformerPlanar<float> FFT(fftSize, FFT_FORWARD);
+        FFTransformerStockham<float> FFTComplex(fftSize, FFT_FORWARD);
+        double tPlanar = 0, tComplex = 0, maxError = 0;
+        for (int i = 0; i < fftNumber; i++)
+        {
+            for (int j = 0; j < fftSize; j++)
+            {
+                re[j] = static_cast<float>(rand()) / RAND_MAX;
+                im[j] = static_cast<float>(rand()) / RAND_MAX;
+            }
+            //split data needs an interleaving copy before the interleaved engine
+            double tStart = omp_get_wtime();
+            for (int j = 0; j < fftSize; j++)
+            {
+                data[j].re = re[j];
+                data[j].im = im[j];
+            }
+            FFTComplex.FFTransform(data);
+            double tEnd = omp_get_wtime();
+            FFT.FFTransform(re, im);
+            tPlanar += omp_get_wtime() - tEnd;
+            tComplex += tEnd - tStart;
+            for (int j = 0; j < fftSize; j++)
+            {
+                double diff = max(fabs(data[j].re - re[j]), fabs(data[j].im - im[j]));
+                if (diff > maxError) maxError = diff;
+            }
+        }
+        cout << "Size " << fftSize << ": planar took " << 1e6*tPlanar/fftNumber << " us, ";
+        cout << "interleave and Stockham took " << 1e6*tComplex/fftNumber << " us, max difference " << maxError << endl;
+    }
+    delete[] re;
+    delete[] im;
+    delete[] data;
+}
+
+void testBatch()
+{
+    static const int fftSizes[] = {64, 256, 1024, 4096};
+    static const int maxMemoryLimit = 4194304;
+    Complex<float> *data = prepareData<float>(maxMemoryLimit);
+    for (int szInd = 0; szInd < 4; szInd++)
+    {
+        int fftSize = fftSizes[szInd];
+        int fftNumber = maxMemoryLimit / fftSize;
+        FFTransformerStockham<float> FFT(fftSize, FFT_FORWARD);
+        double tStart = omp_get_wtime();
+        for (int i = 0; i < fftNumber; i++)
+        {
+            FFT.FFTransform(&data[i * fftSize]);
+        }
+        double tLoop = omp_get_wtime() - tStart;
+        tStart = omp_get_wtime();
+        FFT.FFTransformBatch(data, fftNumber);
+        double tBatch = omp_get_wtime() - tStart;
+        tStart = omp_get_wtime();
+        FFT.FFTransformBatch(data, fftNumber, 1, 0, true);
+        double tParallel = omp_get_wtime() - tStart;
+        cout << "Size " << fftSize << ": loop took " << 1e6*tLoop/fftNumber << " us, ";
+        cout << "batch took " << 1e6*tBatch/fftNumber << " us, ";
+        cout << "parallel batch took " << 1e6*tParallel/fftNumber << " us per transform" << endl;
+    }
+    delete[] data;
+}
+
+void testStrided()
+{
+    //8 interleaved channels, sample k of channel c at data[k * channels + c]
+    static const int fftSizes[] = {1024, 4096, 16384};
+    static const int channels = 8;
+    static const int repeats = 100;
+    for (int szInd = 0; szInd < 3; szInd++)
+    {
+        int fftSize = fftSizes[szInd];
+        Complex<float> *data = prepareData<float>(fftSize * channels);
+        Complex<float> *check = new Complex<float>[fftSize * channels];
+        Complex<float> *result = new Complex<float>[fftSize * channels];
+        FFTransformerVec<float> FFT(fftSize, FFT_FORWARD);
+        //de-interleaved into a contiguous copy, then transformed
+        double tStart = omp_get_wtime();
+        for (int r = 0; r < repeats; r++)
+        {
+            for (int c = 0; c < channels; c++)
+            {
+                for (int k = 0; k < fftSize; k++) check[c * fftSize + k] = data[k * channels + c];
+                FFT.FFTransform(&check[c * fftSize]);
+            }
+        }
+        double tCopy = omp_get_wtime() - tStart;
+        tStart = omp_get_wtime();
+        for (int r = 0; r < repeats; r++)
+        {
+            FFT.FFTransformBatch(data, result, channels, channels, 1);
+        }
+        double tStrided = omp_get_wtime() - tStart;
+        double maxErr = 0;
+        for (int i = 0; i < fftSize * channels; i++)
+        {
+            maxErr = max(maxErr, (double)fabs(result[i].re - check[i].re));
+            maxErr = max(maxErr, (double)fabs(result[i].im - check[i].im));
+        }
+        cout << "Size " << fftSize << ", " << channels << " channels: max error " << maxErr << ", ";
+        cout << "de-interleave and transform took " << 1e6*tCopy/repeats << " us, ";
+        cout << "strided batch took " << 1e6*tStrided/repeats << " us" << endl;
+        delete[] result;
+        delete[] check;
+        delete[] data;
+    }
+}
+
+void testLanes()
+{
+    static const int fftSizes[] = {16, 32, 64, 128, 256};
+    static const int maxMemoryLimit = 4194304;
+    Complex<float> *data = prepareData<float>(maxMemoryLimit);
+    Complex<float> *check = new Complex<float>[8 * 256];
+    for (int szInd = 0; szInd < 5; szInd++)
+    {
+        int fftSize = fftSizes[szInd];
+        int fftNumber = maxMemoryLimit / fftSize;
+        FFTransformerStockham<float> FFT(fftSize, FFT_FORWARD);
+        FFTransformerLanes<float> FFTLanes(fftSize, FFT_FORWARD);
+        //one transform per lane must give the per transform results
+        memcpy(check, data, 8 * fftSize * sizeof(Complex<float>));
+        FFT.FFTransformBatch(check, 8);
+        FFTLanes.FFTransformBatch(data, 8);
+        double maxErr = 0;
+        for (int i = 0; i < 8 * fftSize; i++)
+        {
+            maxErr = max(maxErr, (double)fabs(data[i].re - check[i].re));
+            maxErr = max(maxErr, (double)fabs(data[i].im - check[i].im));
+        }
+        double tStart = omp_get_wtime();
+        FFT.FFTransformBatch(data, fftNumber);
+        double tBatch = omp_get_wtime() - tStart;
+        tStart = omp_get_wtime();
+        FFTLanes.FFTransformBatch(data, fftNumber);
+        double tLanes = omp_get_wtime() - tStart;
+        cout << "Size " << fftSize << ": max error " << maxErr << ", ";
+        cout << "batch took " << 1e6*tBatch/fftNumber << " us, ";
+        cout << "lanes took " << 1e6*tLanes/fftNumber << " us per transform" << endl;
+    }
+    delete[] check;
+    delete[] data;
+}
+
+void testThreadScaling()
+{
+    static const int fftSizes[] = {1048576, 4194304, 16777216};
+    static const int maxMemoryLimit = 16777216;
+    Complex<float> *data = prepareData<float>(maxMemoryLimit);
+    int maxThreads = omp_get_num_procs();
+    for (int szInd = 0; szInd < 3; szInd++)
+    {
+        int fftSize = fftSizes[szInd];
+        FFTransformerRecursive<float> FFT(fftSize, FFT_FORWARD);
+        double tSingle = 0;
+        //1, 2, 4, ... threads and all of them last
+        for (int threads = 1; ; threads = (2 * threads < maxThreads) ? 2 * threads : maxThreads)
+        {
+            omp_set_num_threads(threads);
+            //first run warms the pages and the thread pool
+            FFT.FFTransform(data);
+            double tStart = omp_get_wtime();
+            FFT.FFTransform(data);
+            double tRun = omp_get_wtime() - tStart;
+            if (threads == 1) tSingle = tRun;
+            cout << "Size " << fftSize << ", " << threads << " threads: " << 1e3*tRun << " ms, ";
+            cout << "speedup " << tSingle / tRun << endl;
+            if (threads == maxThreads) break;
+        }
+    }
+    omp_set_num_threads(maxThreads);
+    delete[] data;
+}
+
+void testFourStep()
+{
+    static const int fftSizes[] = {4194304, 16777216, 67108864};
+    for (int szInd = 0; szInd < 3; szInd++)
+    {
+        int fftSize = fftSizes[szInd];
+        Complex<float> *data = prepareData<float>(fftSize);
+        Complex<float> *check = new Complex<float>[fftSize];
+        FFTransformerRecursive<float> FFT(fftSize, FFT_FORWARD);
+        FFTransformerFourStep<float> FFTFourStep(fftSize, FFT_FORWARD);
+        double tStart = omp_get_wtime();
+        FFT.FFTransform(data, check);
+        double tRecursive = omp_get_wtime() - tStart;
+        tStart = omp_get_wtime();
+        FFTFourStep.FFTransform(data);
+        double tFourStep = omp_get_wtime() - tStart;
+        double maxErr = 0;
+        for (int i = 0; i < fftSize; i++)
+        {
+            maxErr = max(maxErr, (double)fabs(data[i].re - check[i].re));
+            maxErr = max(maxErr, (double)fabs(data[i].im - check[i].im));
+        }
+        //relative to the DC bin, the largest one of the positive test data
+        cout << "Size " << fftSize << ": max error " << maxErr / fabs(check[0].re) << ", ";
+        cout << "recursive took " << 1e3*tRecursive << " ms, ";
+        cout << "four-step took " << 1e3*tFourStep << " ms" << endl;
+        delete[] check;
+        delete[] data;
+    }
+}
+
+void test2D()
+{
+    static const int fftSizes[] = {256, 512, 1024, 2048};
+    for (int szInd = 0; szInd < 4; szInd++)
+    {
+        int fftSize = fftSizes[szInd];
+        int points = fftSize * fftSize;
+        Complex<float> *data = prepareData<float>(points);
+        Complex<float> *check = new Complex<float>[points];
+        Complex<float> *columnUnaligned = new Complex<float>[fftSize + 8];
+        Complex<float> *column = (Complex<float>*)(((size_t)columnUnaligned | 31) + 1);
+        memcpy(check, data, points * sizeof(Complex<float>));
+        //row transforms, then every column gathered, transformed and scattered back
+        FFTransformerVec<float> FFT(fftSize, FFT_FORWARD);
+        double tStart = omp_get_wtime();
+        for (int r = 0; r < fftSize; r++)
+        {
+            FFT.FFTransform(&check[r * fftSize]);
+        }
+        for (int c = 0; c < fftSize; c++)
+        {
+            for (int r = 0; r < fftSize; r++) column[r] = check[r * fftSize + c];
+            FFT.FFTransform(column);
+            for (int r = 0; r < fftSize; r++) check[r * fftSize + c] = column[r];
+        }
+        double tRowColumn = omp_get_wtime() - tStart;
+        FFTransformer2D<float> FFT2D(fftSize, fftSize, FFT_FORWARD);
+        tStart = omp_get_wtime();
+        FFT2D.FFTransform(data);
+        double t2D = omp_get_wtime() - tStart;
+        double maxErr = 0;
+        for (int i = 0; i < points; i++)
+        {
+            maxErr = max(maxErr, (double)fabs(data[i].re - check[i].re));
+            maxErr = max(maxErr, (double)fabs(data[i].im - check[i].im));
+        }
+        cout << "Size " << fftSize << "x" << fftSize << ": max error " << maxErr / fabs(check[0].re) << ", ";
+        cout << "rows and gathered columns took " << 1e3*tRowColumn << " ms, ";
+        cout << "2D plan took " << 1e3*t2D << " ms" << endl;
+        delete[] columnUnaligned;
+        delete[] check;
+        delete[] data;
+    }
+}
+
+void test3D()
+{
+    //check against rows and gathered pencils of every dimension on a small volume
+    static const int checkSize = 64;
+    int points = checkSize * checkSize * checkSize;
+    Complex<float> *data = prepareData<float>(points);
+    Complex<float> *check = new Complex<float>[points];
+    Complex<float> *pencilUnaligned = new Complex<float>[checkSize + 8];
+    Complex<float> *pencil = (Complex<float>*)(((size_t)pencilUnaligned | 31) + 1);
+    memcpy(check, data, points * sizeof(Complex<float>));
+    FFTransformerVec<float> FFT(checkSize, FFT_FORWARD);
+    for (int i = 0; i < checkSize * checkSize; i++)
+    {
+        FFT.FFTransform(&check[i * checkSize]);
+    }
+    //pencils along i1, then along i0
+    for (int step = checkSize; step <= checkSize * checkSize; step *= checkSize)
+    {
+        for (int i = 0; i < points; i++)
+        {
+            if ((i / step) % checkSize != 0) continue;
+            for (int j = 0; j < checkSize; j++) pencil[j] = check[i + j * step];
+            FFT.FFTransform(pencil);
+            for (int j = 0; j < checkSize; j++) check[i + j * step] = pencil[j];
+        }
+    }
+    FFTransformer3D<float> FFTCheck(checkSize, checkSize, checkSize, FFT_FORWARD);
+    FFTCheck.FFTransform(data);
+    double maxErr = 0;
+    for (int i = 0; i < points; i++)
+    {
+        maxErr = max(maxErr, (double)fabs(data[i].re - check[i].re));
+        maxErr = max(maxErr, (double)fabs(data[i].im - check[i].im));
+    }
+    cout << "Size " << checkSize << "^3: max error " << maxErr / fabs(check[0].re) << endl;
+    delete[] pencilUnaligned;
+    delete[] check;
+    delete[] data;
+
+    static const int fftSizes[] = {256, 512};
+    int maxThreads = omp_get_num_procs();
+    for (int szInd = 0; szInd < 2; szInd++)
+    {
+        int fftSize = fftSizes[szInd];
+        data = prepareData<float>(fftSize * fftSize * fftSize);
+        FFTransformer3D<float> FFT3D(fftSize, fftSize, fftSize, FFT_FORWARD);
+        double tSingle = 0;
+        //1, 2, 4, ... threads and all of them last
+        for (int threads = 1; ; threads = (2 * threads < maxThreads) ? 2 * threads : maxThreads)
+        {
+            omp_set_num_threads(threads);
+            //first run warms the pages and the thread pool
+            FFT3D.FFTransform(data);
+            double tStart = omp_get_wtime();
+            FFT3D.FFTransform(data);
+            double tRun = omp_get_wtime() - tStart;
+            if (threads == 1) tSingle = tRun;
+            cout << "Size " << fftSize << "^3, " << threads << " threads: " << 1e3*tRun << " ms, ";
+            cout << "speedup " << tSingle / tRun << endl;
+            if (threads == maxThreads) break;
+        }
+        delete[] data;
+    }
+    omp_set_num_threads(maxThreads);
+}
+
+void testPlanner()
+{
+    static const int fftSizes[] = {256, 4096, 65536, 1048576};
+    for (int szInd = 0; szInd < 4; szInd++)
+    {
+        int fftSize = fftSizes[szInd];
+        Complex<float> *data = prepareData<float>(fftSize);
+        double tStart = omp_get_wtime();
+        FFTransformerAuto<float> FFTEstimate(fftSize, FFT_FORWARD, FFT_NORMALIZE_NONE, FFT_PLAN_ESTIMATE);
+        double tEstimate = omp_get_wtime() - tStart;
+        tStart = omp_get_wtime();
+        FFTransformerAuto<float> FFTMeasure(fftSize, FFT_FORWARD, FFT_NORMALIZE_NONE, FFT_PLAN_MEASURE);
+        double tMeasure = omp_get_wtime() - tStart;
+        //the second measured plan of the same transform reuses the choice
+        tStart = omp_get_wtime();
+        FFTransformerAuto<float> FFTAgain(fftSize, FFT_FORWARD, FFT_NORMALIZE_NONE, FFT_PLAN_MEASURE);
+        double tAgain = omp_get_wtime() - tStart;
+        FFTPlanChoice estimated = FFTEstimate.FFTGetChoice();
+        FFTPlanChoice measured = FFTMeasure.FFTGetChoice();
+        FFTEstimate.FFTransform(data);
+        tStart = omp_get_wtime();
+        FFTEstimate.FFTransform(data);
+        double tRunEstimate = omp_get_wtime() - tStart;
+        FFTMeasure.FFTransform(data);
+        tStart = omp_get_wtime();
+        FFTMeasure.FFTransform(data);
+        double tRunMeasure = omp_get_wtime() - tStart;
+        cout << "Size " << fftSize << ": estimate picked " << FFTEngineName(estimated.engine);
+        cout << " in " << 1e3*tEstimate << " ms, runs " << 1e6*tRunEstimate << " us; ";
+        cout << "measure picked " << FFTEngineName(measured.engine);
+        if (measured.engine == FFT_ENGINE_RECURSIVE)
+        {
+            cout << " (leaf " << measured.branchLength << ", tasks from " << measured.parallelLength << ")";
+        }
+        cout << " in " << 1e3*tMeasure << " ms (" << 1e3*tAgain << " ms again), runs " << 1e6*tRunMeasure << " us" << endl;
+        delete[] data;
+    }
+}
+
 template <class T>
 void testFFT()
 {
@@ -91,12 +650,11 @@ void testFFT()
         FFTransformerRecursive<T> *FFT = new FFTransformerRecursive<T>(fftSize, 1);
         tEnd = omp_get_wtime();
         cout << " Done in " << 1e6*(tEnd - tStart) << " us" << endl;
-        memcpy(dataTemp, data, maxMemoryLimit * sizeof(Complex<T>));
         cout << "Testing FFTtransform.." << endl;
         tStart = omp_get_wtime();
         for (int i = 0; i < fftNumber; i++)
         {
-            FFT->FFTransform(&dataTemp[i * fftSize]);
+            FFT->FFTransform(&data[i * fftSize], &dataTemp[i * fftSize]);
         }
         tEnd = omp_get_wtime();
         cout << "Data mean: " << dataTemp[0].re << endl;
@@ -128,6 +686,145 @@ void testFFT()
     }
 }
 
+void testKernelLevels()
+{
+    static const int levels[] = {2, 7, 8, FFT_INSTRSET_FMA3};
+    static const char *names[] = {"SSE2", "AVX", "AVX2", "AVX2+FMA3"};
+    static const int fftSize = 65536;
+    static const int fftNumber = 64;
+    Complex<float> *data = prepareData<float>(fftSize * fftNumber);
+    Complex<double> *dataDouble = prepareData<double>(fftSize * fftNumber);
+    FFTransformerVec<float> FFT(fftSize, 1);
+    FFTransformerVec<double> FFTDouble(fftSize, 1);
+    for (int lvl = 0; lvl < 4; lvl++)
+    {
+        if (!FFTSelectKernels(levels[lvl]))
+        {
+            cout << names[lvl] << " kernels not supported" << endl;
+            continue;
+        }
+        double tStart = omp_get_wtime();
+        for (int i = 0; i < fftNumber; i++)
+        {
+            FFT.FFTransform(&data[i * fftSize]);
+        }
+        double tEnd = omp_get_wtime();
+        cout << names[lvl] << " kernels: transformation took " << 1e6*(tEnd - tStart)/fftNumber << " us";
+        tStart = omp_get_wtime();
+        for (int i = 0; i < fftNumber; i++)
+        {
+            FFTDouble.FFTransform(&dataDouble[i * fftSize]);
+        }
+        tEnd = omp_get_wtime();
+        cout << ", double " << 1e6*(tEnd - tStart)/fftNumber << " us" << endl;
+    }
+    delete[] data;
+    delete[] dataDouble;
+}
+
+//max error of the out of place transform from in to out and of the in place one on out,
+//against check
+template <class FFT>
+double outOfPlaceError(FFT &fft, const Complex<float> *in, Complex<float> *out, const Complex<float> *check, int fftSize)
+{
+    double maxError = 0;
+    fft.FFTransform(in, out);
+    for (int j = 0; j < fftSize; j++)
+    {
+        double diff = max(fabs(out[j].re - check[j].re), fabs(out[j].im - check[j].im));
+        if (diff > maxError) maxError = diff;
+    }
+    memcpy(out, in, fftSize * sizeof(Complex<float>));
+    fft.FFTransform(out);
+    for (int j = 0; j < fftSize; j++)
+    {
+        double diff = max(fabs(out[j].re - check[j].re), fabs(out[j].im - check[j].im));
+        if (diff > maxError) maxError = diff;
+    }
+    return maxError;
+}
+
+void testOutOfPlace()
+{
+    static const int levels[] = {2, 7, 8, FFT_INSTRSET_FMA3};
+    static const char *names[] = {"SSE2", "AVX", "AVX2", "AVX2+FMA3"};
+    static const int fftSizes[] = {256, 768, 4096};
+    static const int maxSize = 4096;
+    //input and output one complex past a 16 byte boundary, aligned like any element of a user array
+    Complex<float> *in_unalign = prepareData<float>(maxSize + 1);
+    Complex<float> *out_unalign = new Complex<float>[maxSize + 1];
+    Complex<float> *in = in_unalign + 1;
+    Complex<float> *out = out_unalign + 1;
+    Complex<float> *check = new Complex<float>[maxSize];
+    for (int lvl = 0; lvl < 4; lvl++)
+    {
+        if (!FFTSelectKernels(levels[lvl]))
+        {
+            cout << names[lvl] << " kernels not supported" << endl;
+            continue;
+        }
+        double maxError = 0;
+        for (int szInd = 0; szInd < 3; szInd++)
+        {
+            int fftSize = fftSizes[szInd];
+            FFTransformerMixed<float> FFTMixed(fftSize, FFT_FORWARD);
+            FFTransformerBluestein<float> FFTBluestein(fftSize, FFT_FORWARD);
+            memcpy(check, in, fftSize * sizeof(Complex<float>));
+            FFTMixed.FFTransform(check);
+            maxError = max(maxError, outOfPlaceError(FFTMixed, in, out, check, fftSize));
+            maxError = max(maxError, outOfPlaceError(FFTBluestein, in, out, check, fftSize));
+            if (fftSize % 3 == 0) continue;
+            FFTransformerStockham<float> FFTStockham(fftSize, FFT_FORWARD);
+            FFTransformerFourStep<float> FFTFourStep(fftSize, FFT_FORWARD);
+            FFTransformerVec<float> FFTVec(fftSize, FFT_FORWARD);
+            FFTransformerRecursive<float> FFTRecursive(fftSize, FFT_FORWARD);
+            maxError = max(maxError, outOfPlaceError(FFTStockham, in, out, check, fftSize));
+            maxError = max(maxError, outOfPlaceError(FFTFourStep, in, out, check, fftSize));
+            maxError = max(maxError, outOfPlaceError(FFTVec, in, out, check, fftSize));
+            maxError = max(maxError, outOfPlaceError(FFTRecursive, in, out, check, fftSize));
+        }
+        cout << names[lvl] << " kernels: out of place and in place on misaligned arrays, max error " << maxError << endl;
+    }
+    delete[] in_unalign;
+    delete[] out_unalign;
+    delete[] check;
+}
+
+void testBitReverse()
+{
+    for (int bits = 14; bits <= 24; bits += 2)
+    {
+        int N = 1 << bits;
+        Complex<float> *data = prepareData<float>(N);
+        uint *shuffle_ind = new uint[N];
+        for (int i = 0; i < N; i++)
+        {
+            shuffle_ind[i] = FFTBitReverse<float>::reverseBits(i, bits);
+        }
+        double tStart = omp_get_wtime();
+        for (int i = 0; i < N; i++)
+        {
+            int rev_ind = shuffle_ind[i];
+            if (rev_ind > i)
+            {
+                Complex<float> t = data[i];
+                data[i] = data[rev_ind];
+                data[rev_ind] = t;
+            }
+        }
+        double tEnd = omp_get_wtime();
+        cout << "Size 2^" << bits << ": table shuffle took " << 1e6*(tEnd - tStart) << " us, ";
+        FFTBitReverse<float> bitReverse;
+        bitReverse.Init(N);
+        tStart = omp_get_wtime();
+        bitReverse.Shuffle(data);
+        tEnd = omp_get_wtime();
+        cout << "blocked shuffle took " << 1e6*(tEnd - tStart) << " us" << endl;
+        delete[] shuffle_ind;
+        delete[] data;
+    }
+}
+
 template <class T>
 void testFFT_2()
 {
@@ -167,8 +864,76 @@ int main()
     compareFFTW3();
     cout << "-----------------" << endl;
 
+    cout << "Comparing Bluestein transform to FFTW3..." << endl;
+    compareBluestein();
+    cout << "-----------------" << endl;
+
+    cout << "Comparing mixed radix and Bluestein transforms..." << endl;
+    testMixedRadix();
+    cout << "-----------------" << endl;
+
+    cout << "Comparing Rader and Bluestein transforms..." << endl;
+    testPrimeLengths();
+    cout << "-----------------" << endl;
+
+    cout << "Comparing real input and complex transforms..." << endl;
+    testRealInput();
+    cout << "-----------------" << endl;
+
+    cout << "Comparing fused and separate normalization..." << endl;
+    testNormalization();
+    cout << "-----------------" << endl;
+
+    cout << "Comparing planar and interleaved transforms..." << endl;
+    testPlanar();
+    cout << "-----------------" << endl;
+
+    cout << "Comparing single and batched transforms..." << endl;
+    testBatch();
+    cout << "-----------------" << endl;
+
+    cout << "Comparing de-interleaved and strided transforms..." << endl;
+    testStrided();
+    cout << "-----------------" << endl;
+
+    cout << "Comparing batched and transform per lane transforms..." << endl;
+    testLanes();
+    cout << "-----------------" << endl;
+
+    cout << "Scaling the recursive transform over threads..." << endl;
+    testThreadScaling();
+    cout << "-----------------" << endl;
+
+    cout << "Comparing four-step and recursive transforms..." << endl;
+    testFourStep();
+    cout << "-----------------" << endl;
+
+    cout << "Comparing 2D plan and row-column transforms..." << endl;
+    test2D();
+    cout << "-----------------" << endl;
+
+    cout << "Checking 3D plan and scaling it over threads..." << endl;
+    test3D();
+    cout << "-----------------" << endl;
+
     //testSin();
 
+    cout << "Comparing estimated and measured plans..." << endl;
+    testPlanner();
+    cout << "-----------------" << endl;
+
+    cout << "Comparing bit reversal permutations..." << endl;
+    testBitReverse();
+    cout << "-----------------" << endl;
+
+    cout << "Comparing kernel instruction sets..." << endl;
+    testKernelLevels();
+    cout << "-----------------" << endl;
+
+    cout << "Comparing out of place and in place transforms..." << endl;
+    testOutOfPlace();
+    cout << "-----------------" << endl;
+
     cout << "Testing float..." << endl;
     testFFT<float>();
     /*